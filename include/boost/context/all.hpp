@@ -6,8 +6,14 @@
 
 #include <boost/context/continuation.hpp>
 #include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/handoff.hpp>
+#include <boost/context/prefaulted_stack.hpp>
 #include <boost/context/pooled_fixedsize_stack.hpp>
 #include <boost/context/protected_fixedsize_stack.hpp>
 #include <boost/context/segmented_stack.hpp>
+#include <boost/context/slab_protected_stack.hpp>
 #include <boost/context/stack_context.hpp>
 #include <boost/context/stack_traits.hpp>
+#include <boost/context/static_continuation.hpp>
+#include <boost/context/static_stack_traits.hpp>
+#include <boost/context/tls_access.hpp>
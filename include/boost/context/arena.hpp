@@ -0,0 +1,152 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_ARENA_H
+#define BOOST_CONTEXT_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/context/detail/arena.hpp>
+#include <boost/context/detail/cls.hpp>
+#include <boost/context/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+#if ! defined(BOOST_USE_ARENA)
+# error "per-context arena requires BOOST_USE_ARENA"
+#endif
+
+namespace boost {
+namespace context {
+
+namespace detail {
+
+// allocations of the main context; over-aligned requests use the aligned
+// operator new (C++17) or keep the address returned by operator new in
+// front of the aligned block
+inline
+void * free_store_allocate( std::size_t size, std::size_t alignment) {
+    if ( alignment <= alignof( std::max_align_t) ) {
+        return ::operator new( size);
+    }
+#if defined(__cpp_aligned_new)
+    return ::operator new( size, std::align_val_t( alignment) );
+#else
+    void * vp = ::operator new( size + alignment + sizeof( void *) );
+    const std::uintptr_t mask = alignment - 1;
+    void ** p = reinterpret_cast< void ** >(
+        ( reinterpret_cast< std::uintptr_t >( vp) + sizeof( void *) + mask) & ~mask);
+    p[-1] = vp;
+    return p;
+#endif
+}
+
+inline
+void free_store_deallocate( void * p, std::size_t alignment) noexcept {
+    if ( alignment <= alignof( std::max_align_t) ) {
+        ::operator delete( p);
+        return;
+    }
+#if defined(__cpp_aligned_new)
+    ::operator delete( p, std::align_val_t( alignment) );
+#else
+    ::operator delete( static_cast< void ** >( p)[-1]);
+#endif
+}
+
+inline
+arena * arena_current() noexcept {
+    cls_block * blk = cls_current();
+    return nullptr != blk ? blk->arena_ : nullptr;
+}
+
+}
+
+// allocates from the arena of the running context; the main context of a
+// thread has no arena and uses the free-store instead
+inline
+void * arena_allocate( std::size_t size, std::size_t alignment = alignof( std::max_align_t) ) {
+    detail::arena * a = detail::arena_current();
+    return nullptr != a
+        ? a->allocate( size, alignment)
+        : detail::free_store_allocate( size, alignment);
+}
+
+// memory owned by the arena of the running context is given back to it,
+// anything else to the free-store; `p` must not belong to the arena of
+// another context (memory of an arena is released in bulk when its context
+// terminates)
+inline
+void arena_deallocate( void * p, std::size_t size, std::size_t alignment = alignof( std::max_align_t) ) noexcept {
+    detail::arena * a = detail::arena_current();
+    if ( nullptr != a && a->owns( p) ) {
+        a->deallocate( p, size);
+    } else {
+        detail::free_store_deallocate( p, alignment);
+    }
+}
+
+// standard allocator bound to the arena of the context it was created on
+// (the free-store on the main context); copies share the arena, allocators
+// of different arenas compare unequal
+template< typename T >
+class arena_allocator {
+private:
+    template< typename U >
+    friend class arena_allocator;
+
+    detail::arena   *   arena_;
+
+public:
+    typedef T   value_type;
+
+    arena_allocator() noexcept :
+        arena_( detail::arena_current() ) {
+    }
+
+    template< typename U >
+    arena_allocator( arena_allocator< U > const& other) noexcept :
+        arena_( other.arena_) {
+    }
+
+    T * allocate( std::size_t n) {
+        return static_cast< T * >( nullptr != arena_
+            ? arena_->allocate( n * sizeof( T), alignof( T) )
+            : detail::free_store_allocate( n * sizeof( T), alignof( T) ) );
+    }
+
+    void deallocate( T * p, std::size_t n) noexcept {
+        if ( nullptr != arena_ && arena_->owns( p) ) {
+            arena_->deallocate( p, n * sizeof( T) );
+        } else {
+            detail::free_store_deallocate( p, alignof( T) );
+        }
+    }
+
+    template< typename U >
+    bool operator==( arena_allocator< U > const& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+
+    template< typename U >
+    bool operator!=( arena_allocator< U > const& other) const noexcept {
+        return arena_ != other.arena_;
+    }
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_ARENA_H
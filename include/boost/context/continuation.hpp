@@ -33,6 +33,9 @@
 #if defined(BOOST_NO_CXX17_STD_INVOKE)
 #include <boost/context/detail/invoke.hpp>
 #endif
+#include <boost/context/detail/arena.hpp>
+#include <boost/context/detail/canary.hpp>
+#include <boost/context/detail/cls.hpp>
 #include <boost/context/detail/disable_overload.hpp>
 #include <boost/context/detail/exception.hpp>
 #include <boost/context/detail/fcontext.hpp>
@@ -54,6 +57,9 @@
 
 namespace boost {
 namespace context {
+
+class handoff;
+
 namespace detail {
 
 template< int N >
@@ -87,15 +93,16 @@ transfer_t context_exit( transfer_t t) noexcept {
 }
 
 template< typename Rec >
-void context_entry( transfer_t t_) noexcept {
-    // transfer control structure to the context-stack
-    Rec * rec = static_cast< Rec * >( t_.data);
-    BOOST_ASSERT( nullptr != t_.fctx);
-    BOOST_ASSERT( nullptr != rec);
-    transfer_t t = { nullptr, nullptr };
+void context_main( Rec * rec, transfer_t t) noexcept {
+#if defined(BOOST_USE_CLS)
+    // continuation-local storage of `this` context becomes active
+    cls_current() = rec->cls();
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+    // checked each time `this` context gets suspended
+    canary_current() = rec->stack();
+#endif
     try {
-        // jump back to `context_create()`
-        t = jump_fcontext( t_.fctx, nullptr);
         // start executing
         t = rec->run( t);
     } catch ( forced_unwind const& e) {
@@ -107,6 +114,62 @@ void context_entry( transfer_t t_) noexcept {
     BOOST_ASSERT_MSG( false, "context already terminated");
 }
 
+// marks a continuation created suspended that was not resumed yet; passed
+// as data of the jump that destroys it
+inline
+void * context_suspended() noexcept {
+    static char tag;
+    return & tag;
+}
+
+// a context created suspended finds its control structure through a pointer
+// stored at the next `context_slot_alignment` boundary above its first frame;
+// the initial fcontext frame and the frame of the entry function stay well
+// below this distance on all supported ABIs
+BOOST_CONSTEXPR_OR_CONST std::size_t context_slot_alignment = 1024;
+
+inline
+void * context_slot( void * sp) noexcept {
+    const std::uintptr_t mask = context_slot_alignment - 1;
+    return * reinterpret_cast< void ** >(
+            ( reinterpret_cast< std::uintptr_t >( sp) + mask) & ~ mask);
+}
+
+template< typename Rec >
+void context_suspended_entry( transfer_t t) noexcept {
+    // entered by the first resume(); no jump preceded it
+#if defined(__GNUC__)
+    Rec * rec = static_cast< Rec * >( context_slot( __builtin_frame_address( 0) ) );
+#else
+    Rec * rec = static_cast< Rec * >( context_slot( & t) );
+#endif
+    BOOST_ASSERT( nullptr != t.fctx);
+    BOOST_ASSERT( nullptr != rec);
+    if ( context_suspended() == t.data) {
+        // destroyed before it was resumed
+        ontop_fcontext( t.fctx, rec, context_exit< Rec >);
+        BOOST_ASSERT_MSG( false, "context already terminated");
+    }
+    context_main( rec, t);
+}
+
+// control structure and data of the first resume(), passed with the very
+// first jump into a new context
+struct launch_t {
+    void    *   rec;
+    void    *   data;
+};
+
+template< typename Rec >
+void context_launch_entry( transfer_t t) noexcept {
+    launch_t * l = static_cast< launch_t * >( t.data);
+    BOOST_ASSERT( nullptr != t.fctx);
+    BOOST_ASSERT( nullptr != l);
+    Rec * rec = static_cast< Rec * >( l->rec);
+    t.data = l->data;
+    context_main( rec, t);
+}
+
 template<
     typename Ctx,
     typename StackAlloc,
@@ -117,9 +180,16 @@ private:
     StackAlloc                                          salloc_;
     stack_context                                       sctx_;
     typename std::decay< Fn >::type                     fn_;
+#if defined(BOOST_USE_CLS)
+    cls_block                                           cls_{};
+#endif
+#if defined(BOOST_USE_ARENA)
+    // occupies the BOOST_CONTEXT_ARENA_SIZE bytes below `this`
+    arena                                               arena_;
+#endif
 
     static void destroy( record * p) noexcept {
-        StackAlloc salloc = p->salloc_;
+        StackAlloc salloc = std::move( p->salloc_);
         stack_context sctx = p->sctx_;
         // deallocate record
         p->~record();
@@ -128,11 +198,18 @@ private:
     }
 
 public:
-    record( stack_context sctx, StackAlloc const& salloc,
+    record( stack_context sctx, StackAlloc && salloc,
             Fn && fn) noexcept :
-        salloc_( salloc),
+        salloc_( std::move( salloc) ),
         sctx_( sctx),
-        fn_( std::forward< Fn >( fn) ) {
+        fn_( std::forward< Fn >( fn) )
+#if defined(BOOST_USE_ARENA)
+        , arena_( reinterpret_cast< char * >( this) - BOOST_CONTEXT_ARENA_SIZE, BOOST_CONTEXT_ARENA_SIZE)
+#endif
+        {
+#if defined(BOOST_USE_ARENA)
+        cls_.arena_ = & arena_;
+#endif
     }
 
     record( record const&) = delete;
@@ -142,6 +219,18 @@ public:
         destroy( this);
     }
 
+#if defined(BOOST_USE_CLS)
+    cls_block * cls() noexcept {
+        return & cls_;
+    }
+#endif
+
+#if defined(BOOST_USE_STACK_CANARY)
+    stack_context const* stack() const noexcept {
+        return & sctx_;
+    }
+#endif
+
     transfer_t run( transfer_t t) {
         Ctx from{ t };
         // invoke context-function
@@ -158,9 +247,42 @@ public:
     }
 };
 
+// creates the fast-context below the control structure at `sp`; a context
+// created suspended gets the slot holding the address of its control structure
+inline
+fcontext_t context_make( void * sp, std::size_t size, void (* entry)( transfer_t), bool suspended) {
+    char * top = static_cast< char * >( sp);
+#if defined(BOOST_USE_ARENA)
+    // the arena is placed between control structure and stack
+    top -= BOOST_CONTEXT_ARENA_SIZE;
+    size -= BOOST_CONTEXT_ARENA_SIZE;
+#endif
+    if ( suspended) {
+        char * slot = reinterpret_cast< char * >(
+                ( reinterpret_cast< std::uintptr_t >( top) - sizeof( void *) ) &
+                ~ static_cast< std::uintptr_t >( context_slot_alignment - 1) );
+        * reinterpret_cast< void ** >( slot) = sp;
+        size -= static_cast< std::size_t >( top - slot);
+        top = slot;
+    }
+    const fcontext_t fctx = make_fcontext( top, size, entry);
+    BOOST_ASSERT( nullptr != fctx);
+    return fctx;
+}
+
+// places the control structure on top of the stack; the new context
+// enters `entry` with the first jump
 template< typename Record, typename StackAlloc, typename Fn >
-fcontext_t context_create( StackAlloc salloc, Fn && fn) {
+transfer_t context_prepare( StackAlloc salloc, Fn && fn, void (* entry)( transfer_t), bool suspended = false) {
     auto sctx = salloc.allocate();
+#if defined(BOOST_USE_ARENA)
+    try {
+        arena_check_stack( sctx.size, sizeof( Record) );
+    } catch (...) {
+        salloc.deallocate( sctx);
+        throw;
+    }
+#endif
     // reserve space for control structure
 #if defined(BOOST_NO_CXX11_CONSTEXPR) || defined(BOOST_NO_CXX11_STD_ALIGN)
     const std::size_t size = sctx.size - sizeof( Record);
@@ -178,17 +300,18 @@ fcontext_t context_create( StackAlloc salloc, Fn && fn) {
     const std::size_t size = sctx.size - ( static_cast< char * >( sctx.sp) - static_cast< char * >( sp) );
 #endif
     // create fast-context
-    const fcontext_t fctx = make_fcontext( sp, size, & context_entry< Record >);
-    BOOST_ASSERT( nullptr != fctx);
+    const fcontext_t fctx = context_make( sp, size, entry, suspended);
     // placment new for control structure on context-stack
     auto rec = ::new ( sp) Record{
-            sctx, salloc, std::forward< Fn >( fn) };
-    // transfer control structure to context-stack
-    return jump_fcontext( fctx, rec).fctx;
+            sctx, std::move( salloc), std::forward< Fn >( fn) };
+    return { fctx, rec };
 }
 
 template< typename Record, typename StackAlloc, typename Fn >
-fcontext_t context_create( preallocated palloc, StackAlloc salloc, Fn && fn) {
+transfer_t context_prepare( preallocated palloc, StackAlloc salloc, Fn && fn, void (* entry)( transfer_t), bool suspended = false) {
+#if defined(BOOST_USE_ARENA)
+    arena_check_stack( palloc.size, sizeof( Record) );
+#endif
     // reserve space for control structure
 #if defined(BOOST_NO_CXX11_CONSTEXPR) || defined(BOOST_NO_CXX11_STD_ALIGN)
     const std::size_t size = palloc.size - sizeof( Record);
@@ -206,13 +329,25 @@ fcontext_t context_create( preallocated palloc, StackAlloc salloc, Fn && fn) {
     const std::size_t size = palloc.size - ( static_cast< char * >( palloc.sp) - static_cast< char * >( sp) );
 #endif
     // create fast-context
-    const fcontext_t fctx = make_fcontext( sp, size, & context_entry< Record >);
-    BOOST_ASSERT( nullptr != fctx);
+    const fcontext_t fctx = context_make( sp, size, entry, suspended);
     // placment new for control structure on context-stack
     auto rec = ::new ( sp) Record{
-            palloc.sctx, salloc, std::forward< Fn >( fn) };
-    // transfer control structure to context-stack
-    return jump_fcontext( fctx, rec).fctx;
+            palloc.sctx, std::move( salloc), std::forward< Fn >( fn) };
+    return { fctx, rec };
+}
+
+// enters the context-function of a context prepared with
+// `context_launch_entry()` right away
+inline
+transfer_t context_launch( transfer_t t, void * data) {
+#if defined(BOOST_USE_CLS)
+    cls_guard guard;
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+    canary_guard canary;
+#endif
+    launch_t l = { t.data, data };
+    return jump_fcontext( t.fctx, & l);
 }
 
 template< typename ... Arg >
@@ -275,6 +410,8 @@ private:
     template< typename Ctx, typename StackAlloc, typename Fn >
     friend class detail::record;
 
+    friend class handoff;
+
     template< typename Ctx, typename Fn, typename ... Arg >
     friend detail::transfer_t
     context_ontop( detail::transfer_t);
@@ -299,6 +436,14 @@ private:
     friend continuation
     callcc( std::allocator_arg_t, preallocated, StackAlloc, Fn &&);
 
+    template< typename StackAlloc, typename Fn >
+    friend continuation
+    make_continuation( std::allocator_arg_t, StackAlloc, Fn &&);
+
+    template< typename StackAlloc, typename Fn >
+    friend continuation
+    make_continuation( std::allocator_arg_t, preallocated, StackAlloc, Fn &&);
+
     detail::transfer_t  t_{ nullptr, nullptr };
 
     continuation( detail::fcontext_t fctx) noexcept :
@@ -314,6 +459,21 @@ public:
 
     ~continuation() {
         if ( nullptr != t_.fctx) {
+#if defined(BOOST_USE_CLS)
+            detail::cls_guard guard;
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+            detail::canary_guard canary;
+#endif
+            if ( detail::context_suspended() == t_.data) {
+                // never resumed: nothing to unwind, the entry releases the stack
+#if defined(BOOST_NO_CXX14_STD_EXCHANGE)
+                detail::jump_fcontext( detail::exchange( t_.fctx, nullptr), t_.data);
+#else
+                detail::jump_fcontext( std::exchange( t_.fctx, nullptr), t_.data);
+#endif
+                return;
+            }
 #if defined(BOOST_NO_CXX14_STD_EXCHANGE)
             detail::ontop_fcontext( detail::exchange( t_.fctx, nullptr), nullptr, detail::context_unwind);
 #else
@@ -341,6 +501,12 @@ public:
     template< typename ... Arg >
     continuation resume( Arg ... arg) {
         BOOST_ASSERT( nullptr != t_.fctx);
+#if defined(BOOST_USE_CLS)
+        detail::cls_guard guard;
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+        detail::canary_guard canary;
+#endif
         auto tpl = std::make_tuple( std::forward< Arg >( arg) ... );
         return detail::jump_fcontext(
 #if defined(BOOST_NO_CXX14_STD_EXCHANGE)
@@ -354,6 +520,12 @@ public:
     template< typename Fn, typename ... Arg >
     continuation resume_with( Fn && fn, Arg ... arg) {
         BOOST_ASSERT( nullptr != t_.fctx);
+#if defined(BOOST_USE_CLS)
+        detail::cls_guard guard;
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+        detail::canary_guard canary;
+#endif
         auto tpl = std::make_tuple( std::forward< Fn >( fn), std::forward< Arg >( arg) ... );
         return detail::ontop_fcontext(
 #if defined(BOOST_NO_CXX14_STD_EXCHANGE)
@@ -367,6 +539,12 @@ public:
 
     continuation resume() {
         BOOST_ASSERT( nullptr != t_.fctx);
+#if defined(BOOST_USE_CLS)
+        detail::cls_guard guard;
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+        detail::canary_guard canary;
+#endif
         return detail::jump_fcontext(
 #if defined(BOOST_NO_CXX14_STD_EXCHANGE)
                     detail::exchange( t_.fctx, nullptr),
@@ -379,6 +557,12 @@ public:
     template< typename Fn >
     continuation resume_with( Fn && fn) {
         BOOST_ASSERT( nullptr != t_.fctx);
+#if defined(BOOST_USE_CLS)
+        detail::cls_guard guard;
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+        detail::canary_guard canary;
+#endif
         auto p = std::make_tuple( std::forward< Fn >( fn) );
         return detail::ontop_fcontext(
 #if defined(BOOST_NO_CXX14_STD_EXCHANGE)
@@ -391,12 +575,13 @@ public:
     }
 
     bool data_available() noexcept {
-        return * this && nullptr != t_.data;
+        return * this && nullptr != t_.data && detail::context_suspended() != t_.data;
     }
 
     template< typename ... Arg >
     typename detail::result_type< Arg ... >::type get_data() {
         BOOST_ASSERT( nullptr != t_.data);
+        BOOST_ASSERT( detail::context_suspended() != t_.data);
         return detail::result_type< Arg ... >::get( t_);
     }
 
@@ -468,10 +653,11 @@ template<
 continuation
 callcc( std::allocator_arg_t, StackAlloc salloc, Fn && fn, Arg ... arg) {
     using Record = detail::record< continuation, StackAlloc, Fn >;
-    return continuation{
-                        detail::context_create< Record >(
-                               salloc, std::forward< Fn >( fn) ) }.resume(
-                   std::forward< Arg >( arg) ... );
+    auto tpl = std::make_tuple( std::forward< Arg >( arg) ... );
+    return detail::context_launch(
+                detail::context_prepare< Record >(
+                        std::move( salloc), std::forward< Fn >( fn), & detail::context_launch_entry< Record >),
+                & tpl);
 }
 
 template<
@@ -482,10 +668,11 @@ template<
 continuation
 callcc( std::allocator_arg_t, preallocated palloc, StackAlloc salloc, Fn && fn, Arg ... arg) {
     using Record = detail::record< continuation, StackAlloc, Fn >;
-    return continuation{
-                        detail::context_create< Record >(
-                               palloc, salloc, std::forward< Fn >( fn) ) }.resume(
-                   std::forward< Arg >( arg) ... );
+    auto tpl = std::make_tuple( std::forward< Arg >( arg) ... );
+    return detail::context_launch(
+                detail::context_prepare< Record >(
+                        palloc, std::move( salloc), std::forward< Fn >( fn), & detail::context_launch_entry< Record >),
+                & tpl);
 }
 
 // void
@@ -504,18 +691,52 @@ template< typename StackAlloc, typename Fn >
 continuation
 callcc( std::allocator_arg_t, StackAlloc salloc, Fn && fn) {
     using Record = detail::record< continuation, StackAlloc, Fn >;
-    return continuation{
-                detail::context_create< Record >(
-                        salloc, std::forward< Fn >( fn) ) }.resume();
+    return detail::context_launch(
+                detail::context_prepare< Record >(
+                        std::move( salloc), std::forward< Fn >( fn), & detail::context_launch_entry< Record >),
+                nullptr);
 }
 
 template< typename StackAlloc, typename Fn >
 continuation
 callcc( std::allocator_arg_t, preallocated palloc, StackAlloc salloc, Fn && fn) {
     using Record = detail::record< continuation, StackAlloc, Fn >;
-    return continuation{
-                detail::context_create< Record >(
-                        palloc, salloc, std::forward< Fn >( fn) ) }.resume();
+    return detail::context_launch(
+                detail::context_prepare< Record >(
+                        palloc, std::move( salloc), std::forward< Fn >( fn), & detail::context_launch_entry< Record >),
+                nullptr);
+}
+
+// created suspended; the first resume() enters `fn`
+template<
+    typename Fn,
+    typename = detail::disable_overload< continuation, Fn >
+>
+continuation
+make_continuation( Fn && fn) {
+    return make_continuation(
+            std::allocator_arg, fixedsize_stack(),
+            std::forward< Fn >( fn) );
+}
+
+template< typename StackAlloc, typename Fn >
+continuation
+make_continuation( std::allocator_arg_t, StackAlloc salloc, Fn && fn) {
+    using Record = detail::record< continuation, StackAlloc, Fn >;
+    return continuation{ detail::transfer_t{
+                detail::context_prepare< Record >(
+                        std::move( salloc), std::forward< Fn >( fn), & detail::context_suspended_entry< Record >, true).fctx,
+                detail::context_suspended() } };
+}
+
+template< typename StackAlloc, typename Fn >
+continuation
+make_continuation( std::allocator_arg_t, preallocated palloc, StackAlloc salloc, Fn && fn) {
+    using Record = detail::record< continuation, StackAlloc, Fn >;
+    return continuation{ detail::transfer_t{
+                detail::context_prepare< Record >(
+                        palloc, std::move( salloc), std::forward< Fn >( fn), & detail::context_suspended_entry< Record >, true).fctx,
+                detail::context_suspended() } };
 }
 
 #if defined(BOOST_USE_SEGMENTED_STACKS)
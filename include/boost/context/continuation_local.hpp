@@ -0,0 +1,83 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_CONTINUATION_LOCAL_H
+#define BOOST_CONTEXT_CONTINUATION_LOCAL_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/context/detail/cls.hpp>
+#include <boost/context/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+#if ! defined(BOOST_USE_CLS)
+# error "continuation-local storage requires BOOST_USE_CLS"
+#endif
+
+namespace boost {
+namespace context {
+namespace detail {
+
+inline
+std::size_t cls_allocate_slot() {
+    static std::atomic< std::size_t > next{ 0 };
+    const std::size_t idx = next++;
+    if ( BOOST_CONTEXT_CLS_SLOTS <= idx) {
+        throw std::length_error("boost.context: continuation-local storage slots exhausted");
+    }
+    return idx;
+}
+
+}
+
+// pointer with a separate value for each continuation (and for the main
+// context of each thread); the value is not owned
+template< typename T >
+class continuation_local_ptr {
+private:
+    std::size_t     idx_;
+
+public:
+    continuation_local_ptr() :
+        idx_( detail::cls_allocate_slot() ) {
+    }
+
+    continuation_local_ptr( continuation_local_ptr const&) = delete;
+    continuation_local_ptr & operator=( continuation_local_ptr const&) = delete;
+
+    T * get() const noexcept {
+        return static_cast< T * >( detail::cls_active()->slots[idx_]);
+    }
+
+    void reset( T * p = nullptr) noexcept {
+        detail::cls_active()->slots[idx_] = p;
+    }
+
+    T * operator->() const noexcept {
+        BOOST_ASSERT( nullptr != get() );
+        return get();
+    }
+
+    T & operator*() const noexcept {
+        BOOST_ASSERT( nullptr != get() );
+        return * get();
+    }
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_CONTINUATION_LOCAL_H
@@ -0,0 +1,139 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_DETAIL_ARENA_H
+#define BOOST_CONTEXT_DETAIL_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/context/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+#if defined(BOOST_USE_ARENA)
+namespace boost {
+namespace context {
+namespace detail {
+
+static_assert( 0 == BOOST_CONTEXT_ARENA_SIZE % 16, "BOOST_CONTEXT_ARENA_SIZE must be a multiple of 16");
+
+// smallest stack left to the context below the arena
+constexpr std::size_t arena_min_stack = 1024;
+
+// `size` bytes of stack must hold the control structure (`record` bytes,
+// aligned), the arena and a minimal stack; the caller keeps the stack
+inline
+void arena_check_stack( std::size_t size, std::size_t record) {
+    if ( size < record + 64 + BOOST_CONTEXT_ARENA_SIZE + arena_min_stack) {
+        throw std::invalid_argument("boost.context: stack too small for the arena");
+    }
+}
+
+// bump allocator living in the space reserved below the control structure
+// of a context; requests that do not fit are served from the free-store and
+// chained, everything is released at once when the context terminates
+class arena {
+private:
+    struct chunk {
+        chunk   *   next;
+        char    *   end;
+    };
+
+    char        *   begin_;
+    char        *   cur_;
+    char        *   end_;
+    chunk       *   overflow_{ nullptr };
+
+    static char * align_up( char * p, std::size_t alignment) noexcept {
+        const std::uintptr_t mask = alignment - 1;
+        return reinterpret_cast< char * >(
+            ( reinterpret_cast< std::uintptr_t >( p) + mask) & ~mask);
+    }
+
+public:
+    arena( void * begin, std::size_t size) noexcept :
+        begin_( static_cast< char * >( begin) ),
+        cur_( begin_),
+        end_( begin_ + size) {
+    }
+
+    ~arena() {
+        release();
+    }
+
+    arena( arena const&) = delete;
+    arena & operator=( arena const&) = delete;
+
+    void * allocate( std::size_t size, std::size_t alignment) {
+        BOOST_ASSERT( 0 != alignment && 0 == ( alignment & ( alignment - 1) ) );
+        char * p = align_up( cur_, alignment);
+        if ( p <= end_ && size <= static_cast< std::size_t >( end_ - p) ) {
+            cur_ = p + size;
+            return p;
+        }
+        // arena exhausted
+        void * vp = ::operator new( sizeof( chunk) + alignment + size);
+        chunk * c = static_cast< chunk * >( vp);
+        c->next = overflow_;
+        c->end = static_cast< char * >( vp) + sizeof( chunk) + alignment + size;
+        overflow_ = c;
+        return align_up( reinterpret_cast< char * >( c + 1), alignment);
+    }
+
+    // memory is reclaimed only if `p` was the most recent allocation;
+    // anything else is released when the context terminates
+    void deallocate( void * p, std::size_t size) noexcept {
+        if ( begin_ <= p && p < end_ && static_cast< char * >( p) + size == cur_) {
+            cur_ = static_cast< char * >( p);
+        }
+    }
+
+    // `p` was served by this arena (from its space or from the free-store)
+    bool owns( void const* p) const noexcept {
+        if ( begin_ <= p && p < end_) {
+            return true;
+        }
+        for ( chunk const* c = overflow_; nullptr != c; c = c->next) {
+            if ( static_cast< void const* >( c + 1) <= p && p < c->end) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t used() const noexcept {
+        return static_cast< std::size_t >( cur_ - begin_);
+    }
+
+    std::size_t capacity() const noexcept {
+        return static_cast< std::size_t >( end_ - begin_);
+    }
+
+    void release() noexcept {
+        while ( nullptr != overflow_) {
+            chunk * c = overflow_;
+            overflow_ = c->next;
+            ::operator delete( c);
+        }
+        cur_ = begin_;
+    }
+};
+
+}}}
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_DETAIL_ARENA_H
@@ -0,0 +1,115 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_DETAIL_CANARY_H
+#define BOOST_CONTEXT_DETAIL_CANARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <boost/config.hpp>
+
+#include <boost/context/detail/config.hpp>
+#include <boost/context/stack_context.hpp>
+#include <boost/context/tls_access.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+#if defined(BOOST_USE_STACK_CANARY)
+namespace boost {
+namespace context {
+namespace detail {
+
+// the canary occupies the lowest BOOST_CONTEXT_CANARY_WORDS words of a stack;
+// the pattern depends on the address, so a copied stack does not pass
+inline
+std::uint64_t canary_value( std::uint64_t const* p) noexcept {
+    return UINT64_C( 0x5a17c0de0badf00d) ^ reinterpret_cast< std::uintptr_t >( p);
+}
+
+// `vp` is the lowest address of the stack
+inline
+void * canary_install( void * vp) noexcept {
+    std::uint64_t * p = static_cast< std::uint64_t * >( vp);
+    for ( std::size_t i = 0; i < BOOST_CONTEXT_CANARY_WORDS; ++i) {
+        p[i] = canary_value( p + i);
+    }
+    return vp;
+}
+
+BOOST_NOINLINE BOOST_NORETURN
+inline
+void canary_failed( stack_context const& sctx, char const* where) noexcept {
+    std::fprintf( stderr,
+            "boost.context: stack overflow detected %s; canary at %p of stack [%p, %p) (%lu bytes) overwritten\n",
+            where, sctx.canary,
+            static_cast< void * >( static_cast< char * >( sctx.sp) - sctx.size), sctx.sp,
+            static_cast< unsigned long >( sctx.size) );
+    std::abort();
+}
+
+// checks the whole canary; called when the stack is deallocated
+inline
+void canary_verify( stack_context const& sctx) noexcept {
+    std::uint64_t const* p = static_cast< std::uint64_t const* >( sctx.canary);
+    if ( nullptr == p) {
+        return;
+    }
+    for ( std::size_t i = 0; i < BOOST_CONTEXT_CANARY_WORDS; ++i) {
+        if ( BOOST_UNLIKELY( canary_value( p + i) != p[i]) ) {
+            canary_failed( sctx, "at deallocation");
+        }
+    }
+}
+
+// stack of the running context; nullptr while the thread runs on its
+// original stack (main context)
+inline
+stack_context const*& canary_current() noexcept {
+    return tls_access( []() noexcept -> stack_context const*& {
+        thread_local stack_context const* current = nullptr;
+        return current;
+    });
+}
+
+// checks the canary of the running context before it gets suspended (only
+// the topmost word, the first to be overwritten by a growing stack) and
+// restores the running context after it has been resumed, possibly on
+// another thread
+class canary_guard {
+private:
+    stack_context const*    sctx_;
+
+public:
+    canary_guard() noexcept :
+        sctx_( canary_current() ) {
+        if ( nullptr != sctx_ && nullptr != sctx_->canary) {
+            std::uint64_t const* p = static_cast< std::uint64_t const* >( sctx_->canary) + BOOST_CONTEXT_CANARY_WORDS - 1;
+            if ( BOOST_UNLIKELY( canary_value( p) != * p) ) {
+                canary_failed( * sctx_, "at context switch");
+            }
+        }
+    }
+
+    ~canary_guard() {
+        canary_current() = sctx_;
+    }
+
+    canary_guard( canary_guard const&) = delete;
+    canary_guard & operator=( canary_guard const&) = delete;
+};
+
+}}}
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_DETAIL_CANARY_H
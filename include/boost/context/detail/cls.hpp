@@ -0,0 +1,87 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_DETAIL_CLS_H
+#define BOOST_CONTEXT_DETAIL_CLS_H
+
+#include <cstddef>
+
+#include <boost/config.hpp>
+
+#include <boost/context/detail/config.hpp>
+#include <boost/context/tls_access.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+#if defined(BOOST_USE_CLS)
+namespace boost {
+namespace context {
+namespace detail {
+
+#if defined(BOOST_USE_ARENA)
+class arena;
+#endif
+
+// continuation-local storage slots; stored in the control structure
+// (record) on top of the context's stack
+struct cls_block {
+    void    *   slots[BOOST_CONTEXT_CLS_SLOTS];
+#if defined(BOOST_USE_ARENA)
+    // nullptr for the main context
+    arena   *   arena_;
+#endif
+};
+
+// slots of the running context; nullptr while the thread runs on its
+// original stack (main context)
+inline
+cls_block *& cls_current() noexcept {
+    return tls_access( []() noexcept -> cls_block *& {
+        thread_local cls_block * current = nullptr;
+        return current;
+    });
+}
+
+inline
+cls_block * cls_active() noexcept {
+    cls_block * blk = cls_current();
+    if ( nullptr == blk) {
+        blk = tls_access( []() noexcept -> cls_block * {
+            thread_local cls_block main_blk = {};
+            return & main_blk;
+        });
+    }
+    return blk;
+}
+
+// restores the slots of the suspended context after it has been resumed,
+// possibly on another thread
+class cls_guard {
+private:
+    cls_block   *   blk_;
+
+public:
+    cls_guard() noexcept :
+        blk_( cls_current() ) {
+    }
+
+    ~cls_guard() {
+        cls_current() = blk_;
+    }
+
+    cls_guard( cls_guard const&) = delete;
+    cls_guard & operator=( cls_guard const&) = delete;
+};
+
+}}}
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_DETAIL_CLS_H
@@ -57,6 +57,45 @@
 # define BOOST_CONTEXT_SEGMENTS 10
 #endif
 
+// jump_fcontext_ret() is provided by the x86_64 SYSV ELF assembler; on
+// AArch64 jump_fcontext() already returns via `ret`
+#if defined(__x86_64__) && defined(__ELF__) && ! defined(__ILP32__)
+# define BOOST_CONTEXT_HAS_JUMP_RET
+#endif
+
+// jump_fcontext_preserve_none() is provided by the same assembler; it can
+// only be called by compilers supporting the preserve_none calling convention
+#if defined(BOOST_CONTEXT_HAS_JUMP_RET) && defined(__has_attribute)
+# if __has_attribute(preserve_none)
+#  define BOOST_CONTEXT_HAS_JUMP_PRESERVE_NONE
+# endif
+#endif
+
+#if defined(BOOST_USE_ARENA)
+// the arena of the running context is found via continuation-local storage
+# if ! defined(BOOST_USE_CLS)
+#  define BOOST_USE_CLS
+# endif
+// bytes reserved for the arena below the control structure of each context
+# if ! defined(BOOST_CONTEXT_ARENA_SIZE)
+#  define BOOST_CONTEXT_ARENA_SIZE 4096
+# endif
+#endif
+
+#if defined(BOOST_USE_STACK_CANARY)
+// words of the canary written at the limit of each stack
+# if ! defined(BOOST_CONTEXT_CANARY_WORDS)
+#  define BOOST_CONTEXT_CANARY_WORDS 8
+# endif
+#endif
+
+#if defined(BOOST_USE_CLS)
+// number of continuation-local storage slots per context
+# if ! defined(BOOST_CONTEXT_CLS_SLOTS)
+#  define BOOST_CONTEXT_CLS_SLOTS 8
+# endif
+#endif
+
 
 #define BOOST_CONTEXT_NO_CXX14_INTEGER_SEQUENCE
 // use rd6 macros for std::integer_sequence
@@ -32,6 +32,20 @@ transfer_t BOOST_CONTEXT_CALLDECL jump_fcontext( fcontext_t const to, void * vp)
 extern "C" BOOST_CONTEXT_DECL
 fcontext_t BOOST_CONTEXT_CALLDECL make_fcontext( void * sp, std::size_t size, void (* fn)( transfer_t) );
 
+#if defined(BOOST_CONTEXT_HAS_JUMP_RET)
+// like jump_fcontext() but keeps the return stack buffer balanced
+extern "C" BOOST_CONTEXT_DECL
+transfer_t BOOST_CONTEXT_CALLDECL jump_fcontext_ret( fcontext_t const to, void * vp);
+#endif
+
+#if defined(BOOST_CONTEXT_HAS_JUMP_PRESERVE_NONE)
+// like jump_fcontext() but saves only RBP; the caller spills the registers
+// it has live
+extern "C" BOOST_CONTEXT_DECL
+__attribute__((preserve_none))
+transfer_t jump_fcontext_preserve_none( fcontext_t const to, void * vp);
+#endif
+
 // based on an idea of Giovanni Derreta
 extern "C" BOOST_CONTEXT_DECL
 transfer_t BOOST_CONTEXT_CALLDECL ontop_fcontext( fcontext_t const to, void * vp, transfer_t (* fn)( transfer_t) );
@@ -0,0 +1,72 @@
+
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_DETAIL_JUMP_PRESERVE_NONE_H
+#define BOOST_CONTEXT_DETAIL_JUMP_PRESERVE_NONE_H
+
+#include <boost/config.hpp>
+
+#include <boost/context/detail/config.hpp>
+#include <boost/context/detail/fcontext.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+// jump_fcontext_minimal() calls jump_fcontext_preserve_none(): directly with
+// compilers supporting the preserve_none calling convention, from inline
+// assembler otherwise (gcc)
+#if defined(BOOST_CONTEXT_HAS_JUMP_PRESERVE_NONE) || \
+    ( defined(BOOST_CONTEXT_HAS_JUMP_RET) && defined(__GNUC__) )
+# define BOOST_CONTEXT_HAS_JUMP_MINIMAL
+#endif
+
+namespace boost {
+namespace context {
+namespace detail {
+
+#if defined(BOOST_CONTEXT_HAS_JUMP_PRESERVE_NONE)
+inline
+transfer_t jump_fcontext_minimal( fcontext_t const to, void * vp) {
+    return jump_fcontext_preserve_none( to, vp);
+}
+#elif defined(BOOST_CONTEXT_HAS_JUMP_MINIMAL)
+// fctx in R12, data in R13, every register except RBP clobbered as with
+// preserve_none; the clobber list tells the compiler which registers to
+// spill. CALL writes below RSP, so RSP is moved below the red zone first
+inline
+transfer_t jump_fcontext_minimal( fcontext_t const to, void * vp) {
+    register void * r12 __asm__("r12") = to;
+    register void * r13 __asm__("r13") = vp;
+    register void * rax __asm__("rax");
+    register void * rdx __asm__("rdx");
+    __asm__ __volatile__ (
+        "leaq -128(%%rsp), %%rsp\n\t"
+        "call jump_fcontext_preserve_none@PLT\n\t"
+        "leaq 128(%%rsp), %%rsp"
+        : "=r" (rax), "=r" (rdx), "+r" (r12), "+r" (r13)
+        :
+        : "rbx", "rcx", "rsi", "rdi", "r8", "r9", "r10", "r11", "r14", "r15",
+          "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",
+          "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15",
+#if defined(__AVX512F__)
+          "xmm16", "xmm17", "xmm18", "xmm19", "xmm20", "xmm21", "xmm22", "xmm23",
+          "xmm24", "xmm25", "xmm26", "xmm27", "xmm28", "xmm29", "xmm30", "xmm31",
+          "k0", "k1", "k2", "k3", "k4", "k5", "k6", "k7",
+#endif
+          "memory", "cc");
+    transfer_t t = { rax, rdx };
+    return t;
+}
+#endif
+
+}}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_DETAIL_JUMP_PRESERVE_NONE_H
@@ -34,6 +34,7 @@
 #include <boost/context/preallocated.hpp>
 #include <boost/context/segmented_stack.hpp>
 #include <boost/context/stack_context.hpp>
+#include <boost/context/tls_access.hpp>
 
 #ifdef BOOST_HAS_ABI_HEADERS
 # include BOOST_ABI_PREFIX
@@ -65,6 +66,12 @@ struct BOOST_CONTEXT_DECL activation_record {
 
     thread_local static ptr_t   current_rec;
 
+    // the address of `current_rec` is computed anew on each call; a context
+    // might have been migrated to another thread since its last switch
+    static ptr_t & current() noexcept {
+        return tls_access( []() noexcept -> ptr_t & { return current_rec; });
+    }
+
     std::atomic< std::size_t >  use_count{ 0 };
     fcontext_t                  fctx{ nullptr };
     stack_context               sctx{};
@@ -88,11 +95,11 @@ struct BOOST_CONTEXT_DECL activation_record {
 
     void * resume( void * vp) {
         // store current activation record in local variable
-        auto from = current_rec.get();
+        auto from = current().get();
         // store `this` in static, thread local pointer
         // `this` will become the active (running) context
         // returned by execution_context::current()
-        current_rec = this;
+        current() = this;
 #if defined(BOOST_USE_SEGMENTED_STACKS)
         // adjust segmented stack properties
         __splitstack_getcontext( from->sctx.segments_ctx);
@@ -110,11 +117,11 @@ struct BOOST_CONTEXT_DECL activation_record {
     template< typename Fn >
     void * resume_ontop( void *  data, Fn && fn) {
         // store current activation record in local variable
-        activation_record * from = current_rec.get();
+        activation_record * from = current().get();
         // store `this` in static, thread local pointer
         // `this` will become the active (running) context
         // returned by execution_context::current()
-        current_rec = this;
+        current() = this;
 #if defined(BOOST_USE_SEGMENTED_STACKS)
         // adjust segmented stack properties
         __splitstack_getcontext( from->sctx.segments_ctx);
@@ -301,7 +308,7 @@ private:
 
     execution_context() noexcept :
         // default constructed with current activation_record
-        ptr_{ detail::activation_record::current_rec } {
+        ptr_{ detail::activation_record::current() } {
     }
 
 public:
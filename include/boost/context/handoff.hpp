@@ -0,0 +1,118 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_HANDOFF_H
+#define BOOST_CONTEXT_HANDOFF_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/detail/config.hpp>
+#include <boost/context/detail/fcontext.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace context {
+
+// single-slot mailbox passing a suspended continuation from one thread to
+// another
+//
+// put() publishes the continuation with release semantics, take() acquires
+// it; everything the continuation wrote to its stack before it was suspended
+// is visible to the thread resuming it. Data passed with the last resume()
+// is not transferred.
+class handoff {
+private:
+    std::atomic< detail::fcontext_t >   fctx_{ nullptr };
+
+    // a continuation that was never resumed is stored with the lowest bit
+    // set (fcontexts are at least 16-byte aligned)
+    static detail::fcontext_t pack( detail::transfer_t const& t) noexcept {
+        if ( detail::context_suspended() != t.data) {
+            return t.fctx;
+        }
+        return reinterpret_cast< detail::fcontext_t >(
+                reinterpret_cast< std::uintptr_t >( t.fctx) | 1);
+    }
+
+    static continuation unpack( detail::fcontext_t fctx) noexcept {
+        const std::uintptr_t v = reinterpret_cast< std::uintptr_t >( fctx);
+        if ( 0 == ( v & 1) ) {
+            return continuation{ fctx };
+        }
+        return continuation{ detail::transfer_t{
+                    reinterpret_cast< detail::fcontext_t >( v & ~ static_cast< std::uintptr_t >( 1) ),
+                    detail::context_suspended() } };
+    }
+
+public:
+    handoff() noexcept = default;
+
+    ~handoff() {
+        // a continuation that was never taken is unwound on this thread: the
+        // assignment destroys the taken continuation
+        try_take() = continuation{};
+    }
+
+    handoff( handoff const&) = delete;
+    handoff & operator=( handoff const&) = delete;
+
+    // on failure `c` is left unchanged
+    bool try_put( continuation && c) noexcept {
+        BOOST_ASSERT( c);
+        detail::fcontext_t expected = nullptr;
+        if ( fctx_.compare_exchange_strong( expected, pack( c.t_),
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed) ) {
+            c.t_ = { nullptr, nullptr };
+            return true;
+        }
+        return false;
+    }
+
+    void put( continuation && c) {
+        while ( ! try_put( std::move( c) ) ) {
+            std::this_thread::yield();
+        }
+    }
+
+    // returns a not-a-context if the slot is empty
+    continuation try_take() noexcept {
+        if ( nullptr == fctx_.load( std::memory_order_relaxed) ) {
+            return continuation{};
+        }
+        return unpack( fctx_.exchange( nullptr, std::memory_order_acquire) );
+    }
+
+    continuation take() {
+        for (;;) {
+            continuation c = try_take();
+            if ( c) {
+                return c;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    bool empty() const noexcept {
+        return nullptr == fctx_.load( std::memory_order_relaxed);
+    }
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_HANDOFF_H
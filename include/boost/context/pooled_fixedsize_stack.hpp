@@ -16,6 +16,7 @@
 #include <boost/config.hpp>
 #include <boost/pool/pool.hpp>
 
+#include <boost/context/detail/canary.hpp>
 #include <boost/context/detail/config.hpp>
 #include <boost/context/stack_context.hpp>
 #include <boost/context/stack_traits.hpp>
@@ -58,12 +59,18 @@ private:
             sctx.sp = static_cast< char * >( vp) + sctx.size;
 #if defined(BOOST_USE_VALGRIND)
             sctx.valgrind_stack_id = VALGRIND_STACK_REGISTER( sctx.sp, vp);
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+            sctx.canary = detail::canary_install( vp);
 #endif
             return sctx;
         }
 
         void deallocate( stack_context & sctx) BOOST_NOEXCEPT_OR_NOTHROW {
             BOOST_ASSERT( sctx.sp);
+#if defined(BOOST_USE_STACK_CANARY)
+            detail::canary_verify( sctx);
+#endif
             BOOST_ASSERT( traits_type::is_unbounded() || ( traits_type::maximum_size() >= sctx.size) );
 
 #if defined(BOOST_USE_VALGRIND)
@@ -89,6 +96,30 @@ private:
 public:
     typedef traitsT traits_type;
 
+    // refers to the pool of a basic_pooled_fixedsize_stack without owning
+    // it; copies are plain pointer copies and never touch the use count.
+    // The basic_pooled_fixedsize_stack must outlive all stacks allocated
+    // via the handle.
+    class handle_type {
+    private:
+        storage *   storage_;
+
+    public:
+        typedef traitsT traits_type;
+
+        explicit handle_type( storage * s) noexcept :
+            storage_( s) {
+        }
+
+        stack_context allocate() {
+            return storage_->allocate();
+        }
+
+        void deallocate( stack_context & sctx) BOOST_NOEXCEPT_OR_NOTHROW {
+            storage_->deallocate( sctx);
+        }
+    };
+
     basic_pooled_fixedsize_stack( std::size_t stack_size = traits_type::default_size(),
                            std::size_t next_size = 32,
                            std::size_t max_size = 0) BOOST_NOEXCEPT_OR_NOTHROW :
@@ -102,6 +133,10 @@ public:
     void deallocate( stack_context & sctx) BOOST_NOEXCEPT_OR_NOTHROW {
         storage_->deallocate( sctx);
     }
+
+    handle_type handle() const noexcept {
+        return handle_type{ storage_.get() };
+    }
 };
 
 typedef basic_pooled_fixedsize_stack< stack_traits >  pooled_fixedsize_stack;
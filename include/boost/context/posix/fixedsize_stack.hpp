@@ -14,6 +14,7 @@
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
 
+#include <boost/context/detail/canary.hpp>
 #include <boost/context/detail/config.hpp>
 #include <boost/context/stack_context.hpp>
 #include <boost/context/stack_traits.hpp>
@@ -51,12 +52,18 @@ public:
         sctx.sp = static_cast< char * >( vp) + sctx.size;
 #if defined(BOOST_USE_VALGRIND)
         sctx.valgrind_stack_id = VALGRIND_STACK_REGISTER( sctx.sp, vp);
+#endif
+#if defined(BOOST_USE_STACK_CANARY)
+        sctx.canary = detail::canary_install( vp);
 #endif
         return sctx;
     }
 
     void deallocate( stack_context & sctx) BOOST_NOEXCEPT_OR_NOTHROW {
         BOOST_ASSERT( sctx.sp);
+#if defined(BOOST_USE_STACK_CANARY)
+        detail::canary_verify( sctx);
+#endif
 
 #if defined(BOOST_USE_VALGRIND)
         VALGRIND_STACK_DEREGISTER( sctx.valgrind_stack_id);
@@ -14,7 +14,6 @@ extern "C" {
 #include <unistd.h>
 }
 
-#include <cmath>
 #include <cstddef>
 #include <new>
 
@@ -50,12 +49,10 @@ public:
 
     stack_context allocate() {
         // page at bottom will be used as guard-page
-        const std::size_t pages(
-            static_cast< std::size_t >( 
-                std::floor(
-                    static_cast< float >( size_) / traits_type::page_size() ) ) );
+        const std::size_t page_size = traits_type::page_size();
+        const std::size_t pages = size_ / page_size;
         BOOST_ASSERT_MSG( 2 <= pages, "at least two pages must fit into stack (one page is guard-page)");
-        const std::size_t size__( pages * traits_type::page_size() );
+        const std::size_t size__( pages * page_size);
         BOOST_ASSERT( 0 != size_ && 0 != size__);
         BOOST_ASSERT( size__ <= size_);
 
@@ -69,9 +66,9 @@ public:
 
         // conforming to POSIX.1-2001
 #if defined(BOOST_DISABLE_ASSERTS)
-        ::mprotect( vp, traits_type::page_size(), PROT_NONE);
+        ::mprotect( vp, page_size, PROT_NONE);
 #else
-        const int result( ::mprotect( vp, traits_type::page_size(), PROT_NONE) );
+        const int result( ::mprotect( vp, page_size, PROT_NONE) );
         BOOST_ASSERT( 0 == result);
 #endif
 
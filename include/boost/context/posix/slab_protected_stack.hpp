@@ -0,0 +1,280 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_SLAB_PROTECTED_STACK_H
+#define BOOST_CONTEXT_SLAB_PROTECTED_STACK_H
+
+extern "C" {
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+}
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/intrusive_ptr.hpp>
+
+#include <boost/context/detail/config.hpp>
+#include <boost/context/stack_context.hpp>
+#include <boost/context/stack_traits.hpp>
+
+#if defined(BOOST_USE_VALGRIND)
+#include <valgrind/valgrind.h>
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace context {
+namespace detail {
+
+// number of lines of a file of procfs, 0 if it can not be read
+inline
+std::size_t proc_count_lines( char const* path) noexcept {
+    const int fd = ::open( path, O_RDONLY);
+    if ( -1 == fd) {
+        return 0;
+    }
+    std::size_t lines = 0;
+    char buffer[4096];
+    for (;;) {
+        const ::ssize_t n = ::read( fd, buffer, sizeof( buffer) );
+        if ( 0 > n && EINTR == errno) {
+            continue;
+        }
+        if ( 0 >= n) {
+            break;
+        }
+        for ( ::ssize_t i = 0; i < n; ++i) {
+            if ( '\n' == buffer[i]) {
+                ++lines;
+            }
+        }
+    }
+    ::close( fd);
+    return lines;
+}
+
+}
+
+// number of memory mappings (VMAs) of the process, 0 if unknown
+inline
+std::size_t process_vma_count() noexcept {
+    return detail::proc_count_lines( "/proc/self/maps");
+}
+
+// limit of VMAs per process (vm.max_map_count), 0 if unknown
+inline
+std::size_t max_vma_count() noexcept {
+    const int fd = ::open( "/proc/sys/vm/max_map_count", O_RDONLY);
+    if ( -1 == fd) {
+        return 0;
+    }
+    char buffer[32];
+    const ::ssize_t n = ::read( fd, buffer, sizeof( buffer) );
+    ::close( fd);
+    std::size_t value = 0;
+    for ( ::ssize_t i = 0; i < n && '0' <= buffer[i] && '9' >= buffer[i]; ++i) {
+        value = 10 * value + ( buffer[i] - '0');
+    }
+    return value;
+}
+
+// protected stacks carved from large mappings (slabs)
+//
+// Each stack has a guard page at its bottom, which also separates it from
+// the top of the stack below. If the kernel supports guard regions
+// (MADV_GUARD_INSTALL, Linux 6.13) the guard pages do not split the mapping
+// and a slab consumes a single VMA; otherwise mprotect() is used and each
+// stack costs two VMAs, as with protected_fixedsize_stack.
+// Deallocated stacks are reused; slabs are unmapped when the last copy of
+// the allocator is destroyed. Copies share the slabs, guarded by a mutex.
+template< typename traitsT >
+class basic_slab_protected_stack {
+public:
+    typedef traitsT traits_type;
+
+private:
+    class storage {
+    private:
+        std::atomic< std::size_t >      use_count_;
+        std::size_t                     page_size_;
+        std::size_t                     stack_size_;
+        std::size_t                     stacks_per_slab_;
+        mutable std::mutex              mtx_{};
+        std::vector< void * >           slabs_{};
+        std::vector< void * >           free_{};
+        // next stack of the newest slab never handed out
+        std::size_t                     next_;
+#if defined(__linux__)
+        bool                            guard_regions_{ true };
+#else
+        bool                            guard_regions_{ false };
+#endif
+
+        bool protect_( void * vp) noexcept {
+#if defined(__linux__)
+# if defined(MADV_GUARD_INSTALL)
+            const int guard_install = MADV_GUARD_INSTALL;
+# else
+            const int guard_install = 102;
+# endif
+            if ( guard_regions_) {
+                if ( 0 == ::madvise( vp, page_size_, guard_install) ) {
+                    return true;
+                }
+                // kernel older than 6.13
+                guard_regions_ = false;
+            }
+#endif
+            // conforming to POSIX.1-2001
+            return 0 == ::mprotect( vp, page_size_, PROT_NONE);
+        }
+
+        void add_slab_() {
+            const std::size_t size = stacks_per_slab_ * stack_size_;
+            slabs_.reserve( slabs_.size() + 1);
+            free_.reserve( ( slabs_.size() + 1) * stacks_per_slab_);
+            // conform to POSIX.4 (POSIX.1b-1993, _POSIX_C_SOURCE=199309L)
+#if defined(MAP_ANON)
+            void * vp = ::mmap( 0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+#else
+            void * vp = ::mmap( 0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#endif
+            if ( MAP_FAILED == vp) {
+                throw std::bad_alloc();
+            }
+            for ( std::size_t i = 0; i < stacks_per_slab_; ++i) {
+                if ( ! protect_( static_cast< char * >( vp) + i * stack_size_) ) {
+                    // vm.max_map_count reached
+                    ::munmap( vp, size);
+                    throw std::bad_alloc();
+                }
+            }
+            slabs_.push_back( vp);
+            next_ = 0;
+        }
+
+    public:
+        storage( std::size_t stack_size, std::size_t stacks_per_slab) :
+            use_count_( 0),
+            page_size_( traits_type::page_size() ),
+            stack_size_( ( stack_size / page_size_) * page_size_),
+            stacks_per_slab_( stacks_per_slab),
+            next_( stacks_per_slab) {
+            BOOST_ASSERT_MSG( 2 * page_size_ <= stack_size_, "at least two pages must fit into stack (one page is guard-page)");
+            BOOST_ASSERT( 0 < stacks_per_slab_);
+        }
+
+        ~storage() {
+            for ( void * vp : slabs_) {
+                ::munmap( vp, stacks_per_slab_ * stack_size_);
+            }
+        }
+
+        stack_context allocate() {
+            void * vp = nullptr;
+            {
+                std::unique_lock< std::mutex > lk( mtx_);
+                if ( ! free_.empty() ) {
+                    vp = free_.back();
+                    free_.pop_back();
+                } else {
+                    if ( stacks_per_slab_ == next_) {
+                        add_slab_();
+                    }
+                    vp = static_cast< char * >( slabs_.back() ) + next_ * stack_size_;
+                    ++next_;
+                }
+            }
+            stack_context sctx;
+            sctx.size = stack_size_;
+            sctx.sp = static_cast< char * >( vp) + sctx.size;
+#if defined(BOOST_USE_VALGRIND)
+            sctx.valgrind_stack_id = VALGRIND_STACK_REGISTER( sctx.sp, vp);
+#endif
+            return sctx;
+        }
+
+        void deallocate( stack_context & sctx) noexcept {
+            BOOST_ASSERT( sctx.sp);
+            BOOST_ASSERT( stack_size_ == sctx.size);
+#if defined(BOOST_USE_VALGRIND)
+            VALGRIND_STACK_DEREGISTER( sctx.valgrind_stack_id);
+#endif
+            std::unique_lock< std::mutex > lk( mtx_);
+            // capacity reserved by add_slab_(); push_back() does not throw
+            free_.push_back( static_cast< char * >( sctx.sp) - sctx.size);
+        }
+
+        std::size_t vma_count() const noexcept {
+            std::unique_lock< std::mutex > lk( mtx_);
+            // without guard regions: guard page and stack alternate
+            return guard_regions_
+                ? slabs_.size()
+                : slabs_.size() * 2 * stacks_per_slab_;
+        }
+
+        bool guard_regions() const noexcept {
+            std::unique_lock< std::mutex > lk( mtx_);
+            return guard_regions_;
+        }
+
+        friend void intrusive_ptr_add_ref( storage * s) noexcept {
+            ++s->use_count_;
+        }
+
+        friend void intrusive_ptr_release( storage * s) noexcept {
+            if ( 0 == --s->use_count_) {
+                delete s;
+            }
+        }
+    };
+
+    intrusive_ptr< storage >    storage_;
+
+public:
+    basic_slab_protected_stack( std::size_t size = traits_type::default_size(),
+                                std::size_t stacks_per_slab = 64) :
+        storage_( new storage( size, stacks_per_slab) ) {
+    }
+
+    stack_context allocate() {
+        return storage_->allocate();
+    }
+
+    void deallocate( stack_context & sctx) BOOST_NOEXCEPT_OR_NOTHROW {
+        storage_->deallocate( sctx);
+    }
+
+    // VMAs consumed by the slabs; the kernel might merge adjacent slabs
+    std::size_t vma_count() const noexcept {
+        return storage_->vma_count();
+    }
+
+    // true if guard pages do not split the slabs (MADV_GUARD_INSTALL)
+    bool guard_regions() const noexcept {
+        return storage_->guard_regions();
+    }
+};
+
+typedef basic_slab_protected_stack< stack_traits >  slab_protected_stack;
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_SLAB_PROTECTED_STACK_H
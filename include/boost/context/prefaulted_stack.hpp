@@ -0,0 +1,263 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_PREFAULTED_STACK_H
+#define BOOST_CONTEXT_PREFAULTED_STACK_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/intrusive_ptr.hpp>
+
+#include <boost/context/detail/config.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/context/slab_protected_stack.hpp>
+#include <boost/context/stack_context.hpp>
+
+#if defined(BOOST_WINDOWS)
+extern "C" {
+#include <windows.h>
+}
+#else
+extern "C" {
+#include <sys/mman.h>
+}
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace context {
+
+// stack allocators whose stacks are made up of whole pages; only those can
+// be locked by basic_prefaulted_stack
+template< typename StackAllocator >
+struct is_page_aligned_stack : public std::false_type {
+};
+
+template< typename traitsT >
+struct is_page_aligned_stack< basic_protected_fixedsize_stack< traitsT > > : public std::true_type {
+};
+
+#if ! defined(BOOST_WINDOWS)
+template< typename traitsT >
+struct is_page_aligned_stack< basic_slab_protected_stack< traitsT > > : public std::true_type {
+};
+#endif
+
+// stack allocator adaptor; the top `prefault_size` bytes of each stack
+// returned by StackAllocator are touched (and optionally locked into RAM)
+// before the stack is handed out, so the continuation does not take page
+// faults on first use
+//
+// reserve() pre-creates stacks at startup; up to the number of reserved
+// stacks are kept on deallocate() and handed out again by allocate().
+// Copies share the cache, which is guarded by a mutex.
+template< typename StackAllocator >
+class basic_prefaulted_stack {
+public:
+    typedef typename StackAllocator::traits_type    traits_type;
+
+private:
+    class storage {
+    private:
+        std::atomic< std::size_t >          use_count_;
+        StackAllocator                      salloc_;
+        std::size_t                         prefault_size_;
+        bool                                lock_;
+        std::mutex                          mtx_{};
+        std::vector< stack_context >        cache_{};
+        std::size_t                         max_cached_{ 0 };
+
+        // the lowest page is never touched; it might be a guard page
+        std::size_t prefault_size( stack_context const& sctx) const noexcept {
+            const std::size_t page_size = traits_type::page_size();
+            return sctx.size > page_size
+                ? ( std::min)( prefault_size_, sctx.size - page_size)
+                : 0;
+        }
+
+        void * prefault_bottom( stack_context const& sctx) const noexcept {
+            return static_cast< char * >( sctx.sp) - prefault_size( sctx);
+        }
+
+        bool lockable( stack_context const& sctx) const noexcept {
+            return lock_ && 0 != prefault_size( sctx);
+        }
+
+        stack_context create() {
+            stack_context sctx = salloc_.allocate();
+            const std::size_t size = prefault_size( sctx);
+            if ( 0 != size) {
+                // one write per page, from the top of the stack downwards;
+                // pages only partially covered at both ends are included
+                const std::uintptr_t page_size = traits_type::page_size();
+                const std::uintptr_t bottom = reinterpret_cast< std::uintptr_t >( prefault_bottom( sctx) );
+                std::uintptr_t page = ( reinterpret_cast< std::uintptr_t >( sctx.sp) - 1) & ~( page_size - 1);
+                for (;;) {
+                    * reinterpret_cast< volatile char * >( ( std::max)( page, bottom) ) = 0;
+                    if ( page <= bottom) {
+                        break;
+                    }
+                    page -= page_size;
+                }
+            }
+            if ( lockable( sctx) ) {
+                BOOST_ASSERT( 0 == ( reinterpret_cast< std::uintptr_t >( sctx.sp) & ( traits_type::page_size() - 1) ) );
+#if defined(BOOST_WINDOWS)
+                const bool locked = FALSE != ::VirtualLock( prefault_bottom( sctx), size);
+#else
+                const bool locked = 0 == ::mlock( prefault_bottom( sctx), size);
+#endif
+                if ( ! locked) {
+                    // RLIMIT_MEMLOCK (POSIX) or the working set size (Windows) exceeded
+                    salloc_.deallocate( sctx);
+                    throw std::bad_alloc();
+                }
+            }
+            return sctx;
+        }
+
+        void destroy( stack_context & sctx) noexcept {
+            if ( lockable( sctx) ) {
+#if defined(BOOST_WINDOWS)
+                ::VirtualUnlock( prefault_bottom( sctx), prefault_size( sctx) );
+#else
+                ::munlock( prefault_bottom( sctx), prefault_size( sctx) );
+#endif
+            }
+            salloc_.deallocate( sctx);
+        }
+
+    public:
+        storage( std::size_t prefault_size, bool lock, StackAllocator && salloc) :
+            use_count_( 0),
+            salloc_( std::move( salloc) ),
+            prefault_size_( prefault_size),
+            lock_( lock) {
+            if ( lock_ && ! is_page_aligned_stack< StackAllocator >::value) {
+                // the pages at the ends of e.g. a stack of fixedsize_stack might
+                // be shared with other heap memory, which munlock() would unlock too
+                throw std::invalid_argument("boost.context: only stacks made up of whole pages can be locked");
+            }
+        }
+
+        ~storage() {
+            for ( stack_context & sctx : cache_) {
+                destroy( sctx);
+            }
+        }
+
+        stack_context allocate() {
+            {
+                std::unique_lock< std::mutex > lk( mtx_);
+                if ( ! cache_.empty() ) {
+                    stack_context sctx = cache_.back();
+                    cache_.pop_back();
+                    return sctx;
+                }
+            }
+            return create();
+        }
+
+        void deallocate( stack_context & sctx) noexcept {
+            BOOST_ASSERT( sctx.sp);
+            {
+                std::unique_lock< std::mutex > lk( mtx_);
+                if ( cache_.size() < max_cached_) {
+                    // capacity was reserved by reserve(); push_back() does not throw
+                    cache_.push_back( sctx);
+                    return;
+                }
+            }
+            destroy( sctx);
+        }
+
+        void reserve( std::size_t n) {
+            std::vector< stack_context > stacks;
+            stacks.reserve( n);
+            try {
+                for ( std::size_t i = 0; i < n; ++i) {
+                    stacks.push_back( create() );
+                }
+                std::unique_lock< std::mutex > lk( mtx_);
+                // stacks handed out might come back; make room for them too
+                cache_.reserve( max_cached_ + n);
+                max_cached_ += n;
+                cache_.insert( cache_.end(), stacks.begin(), stacks.end() );
+            } catch (...) {
+                for ( stack_context & sctx : stacks) {
+                    destroy( sctx);
+                }
+                throw;
+            }
+        }
+
+        std::size_t cached() noexcept {
+            std::unique_lock< std::mutex > lk( mtx_);
+            return cache_.size();
+        }
+
+        friend void intrusive_ptr_add_ref( storage * s) noexcept {
+            ++s->use_count_;
+        }
+
+        friend void intrusive_ptr_release( storage * s) noexcept {
+            if ( 0 == --s->use_count_) {
+                delete s;
+            }
+        }
+    };
+
+    intrusive_ptr< storage >    storage_;
+
+public:
+    basic_prefaulted_stack( std::size_t prefault_size = 16 * 1024,
+                            bool lock = false,
+                            StackAllocator salloc = StackAllocator() ) :
+        storage_( new storage( prefault_size, lock, std::move( salloc) ) ) {
+    }
+
+    stack_context allocate() {
+        return storage_->allocate();
+    }
+
+    void deallocate( stack_context & sctx) BOOST_NOEXCEPT_OR_NOTHROW {
+        storage_->deallocate( sctx);
+    }
+
+    // pre-creates `n` prefaulted stacks, e.g. at startup
+    void reserve( std::size_t n) {
+        storage_->reserve( n);
+    }
+
+    // number of prefaulted stacks ready to be handed out
+    std::size_t cached() const noexcept {
+        return storage_->cached();
+    }
+};
+
+typedef basic_prefaulted_stack< fixedsize_stack >             prefaulted_fixedsize_stack;
+typedef basic_prefaulted_stack< protected_fixedsize_stack >   prefaulted_protected_fixedsize_stack;
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_PREFAULTED_STACK_H
@@ -34,6 +34,10 @@ struct stack_context {
 # if defined(BOOST_USE_VALGRIND)
     unsigned                valgrind_stack_id{ 0 };
 # endif
+# if defined(BOOST_USE_STACK_CANARY)
+    // nullptr if the stack allocator did not install a canary
+    void                *   canary{ nullptr };
+# endif
 };
 #else
 struct stack_context {
@@ -49,6 +53,9 @@ struct stack_context {
 # if defined(BOOST_USE_VALGRIND)
     unsigned                valgrind_stack_id;
 # endif
+# if defined(BOOST_USE_STACK_CANARY)
+    void                *   canary;
+# endif
 
     stack_context() :
         size( 0),
@@ -58,6 +65,9 @@ struct stack_context {
 # endif
 # if defined(BOOST_USE_VALGRIND)
         , valgrind_stack_id( 0)
+# endif
+# if defined(BOOST_USE_STACK_CANARY)
+        , canary( 0)
 # endif
         {}
 };
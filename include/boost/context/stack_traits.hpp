@@ -33,6 +33,53 @@ struct BOOST_CONTEXT_DECL stack_traits
     static std::size_t maximum_size() BOOST_NOEXCEPT_OR_NOTHROW;
 };
 
+namespace detail {
+
+// values of stack_traits, determined while the library is loaded
+struct stack_traits_cache {
+    std::size_t     page_size;
+    std::size_t     default_size;
+    std::size_t     minimum_size;
+    std::size_t     maximum_size;
+    bool            is_unbounded;
+};
+
+extern BOOST_CONTEXT_DECL stack_traits_cache stack_traits_values;
+
+}
+
+// same values as stack_traits but read from a plain global instead of
+// calling into the library; falls back to stack_traits if used by a static
+// initializer that runs before the library has been initialized
+struct cached_stack_traits
+{
+    static bool is_unbounded() BOOST_NOEXCEPT_OR_NOTHROW {
+        return 0 != detail::stack_traits_values.page_size
+            ? detail::stack_traits_values.is_unbounded
+            : stack_traits::is_unbounded();
+    }
+
+    static std::size_t page_size() BOOST_NOEXCEPT_OR_NOTHROW {
+        const std::size_t size = detail::stack_traits_values.page_size;
+        return 0 != size ? size : stack_traits::page_size();
+    }
+
+    static std::size_t default_size() BOOST_NOEXCEPT_OR_NOTHROW {
+        const std::size_t size = detail::stack_traits_values.default_size;
+        return 0 != size ? size : stack_traits::default_size();
+    }
+
+    static std::size_t minimum_size() BOOST_NOEXCEPT_OR_NOTHROW {
+        const std::size_t size = detail::stack_traits_values.minimum_size;
+        return 0 != size ? size : stack_traits::minimum_size();
+    }
+
+    static std::size_t maximum_size() BOOST_NOEXCEPT_OR_NOTHROW {
+        const std::size_t size = detail::stack_traits_values.maximum_size;
+        return 0 != size ? size : stack_traits::maximum_size();
+    }
+};
+
 }}
 
 #ifdef BOOST_HAS_ABI_HEADERS
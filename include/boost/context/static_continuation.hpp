@@ -0,0 +1,139 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_STATIC_CONTINUATION_H
+#define BOOST_CONTEXT_STATIC_CONTINUATION_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/detail/config.hpp>
+#include <boost/context/preallocated.hpp>
+#include <boost/context/stack_context.hpp>
+
+#if defined(BOOST_USE_VALGRIND)
+#include <valgrind/valgrind.h>
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace context {
+namespace detail {
+
+// the stack is owned by static_continuation; nothing to allocate or free
+struct embedded_stack {
+    stack_context allocate() {
+        BOOST_ASSERT_MSG( false, "embedded stack is preallocated");
+        return stack_context{};
+    }
+
+    void deallocate( stack_context & sctx) BOOST_NOEXCEPT_OR_NOTHROW {
+#if defined(BOOST_USE_VALGRIND)
+        VALGRIND_STACK_DEREGISTER( sctx.valgrind_stack_id);
+#else
+        ( void)sctx;
+#endif
+    }
+};
+
+}
+
+// smallest stack of static_continuation; destroying a suspended context
+// throws (unwinds) on its stack, which needs more than 4 KiB
+#if defined(BOOST_USE_ARENA)
+constexpr std::size_t static_continuation_min_stack = 8 * 1024 + BOOST_CONTEXT_ARENA_SIZE;
+#else
+constexpr std::size_t static_continuation_min_stack = 8 * 1024;
+#endif
+
+// continuation whose stack is a member array; the object can neither be
+// copied nor moved, arrays of it are one contiguous allocation
+//
+// The stack has no guard page; StackBytes must cover the deepest call chain
+// of the context-function.
+template< std::size_t StackBytes >
+class static_continuation {
+private:
+    static_assert( static_continuation_min_stack <= StackBytes, "stack of static_continuation too small");
+
+    alignas( 64) char   stack_[StackBytes];
+    continuation        c_{};
+
+public:
+    static_continuation() noexcept {
+    }
+
+    // created suspended; the first resume() enters `fn`
+    template< typename Fn >
+    explicit static_continuation( Fn && fn) {
+        reset( std::forward< Fn >( fn) );
+    }
+
+    static_continuation( static_continuation const&) = delete;
+    static_continuation & operator=( static_continuation const&) = delete;
+
+    // unwinds the current context (if any) and prepares a new one executing
+    // `fn` on the embedded stack
+    template< typename Fn >
+    void reset( Fn && fn) {
+        c_ = continuation{};
+        stack_context sctx;
+        sctx.size = StackBytes;
+        sctx.sp = stack_ + StackBytes;
+#if defined(BOOST_USE_VALGRIND)
+        sctx.valgrind_stack_id = VALGRIND_STACK_REGISTER( sctx.sp, stack_);
+#endif
+        c_ = make_continuation(
+                std::allocator_arg, preallocated( sctx.sp, sctx.size, sctx),
+                detail::embedded_stack{}, std::forward< Fn >( fn) );
+    }
+
+    // resumes the context; afterwards `*this` represents it suspended again
+    // (or not-a-context if it has terminated)
+    template< typename ... Arg >
+    static_continuation & resume( Arg ... arg) {
+        c_ = c_.resume( std::forward< Arg >( arg) ... );
+        return * this;
+    }
+
+    template< typename Fn, typename ... Arg >
+    static_continuation & resume_with( Fn && fn, Arg ... arg) {
+        c_ = c_.resume_with( std::forward< Fn >( fn), std::forward< Arg >( arg) ... );
+        return * this;
+    }
+
+    bool data_available() noexcept {
+        return c_.data_available();
+    }
+
+    template< typename ... Arg >
+    typename detail::result_type< Arg ... >::type get_data() {
+        return c_.template get_data< Arg ... >();
+    }
+
+    explicit operator bool() const noexcept {
+        return static_cast< bool >( c_);
+    }
+
+    bool operator!() const noexcept {
+        return ! c_;
+    }
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_STATIC_CONTINUATION_H
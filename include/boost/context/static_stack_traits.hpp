@@ -0,0 +1,61 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_STATIC_STACK_TRAITS_H
+#define BOOST_CONTEXT_STATIC_STACK_TRAITS_H
+
+#include <cstddef>
+#include <limits>
+
+#include <boost/config.hpp>
+
+#include <boost/context/detail/config.hpp>
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace context {
+
+// stack traits known at compile time; usable as `traitsT` of the stack
+// allocators, all sizing computations are constant-folded
+//
+// PageSize must match the page size of the target system if used with
+// protected_fixedsize_stack. The stack size is not limited.
+template< std::size_t PageSize, std::size_t DefaultSize, std::size_t MinSize >
+struct static_stack_traits {
+    static_assert( 0 != PageSize && 0 == ( PageSize & ( PageSize - 1) ), "PageSize must be a power of two");
+    static_assert( MinSize <= DefaultSize, "DefaultSize must not be smaller than MinSize");
+
+    static constexpr bool is_unbounded() noexcept {
+        return true;
+    }
+
+    static constexpr std::size_t page_size() noexcept {
+        return PageSize;
+    }
+
+    static constexpr std::size_t default_size() noexcept {
+        return DefaultSize;
+    }
+
+    static constexpr std::size_t minimum_size() noexcept {
+        return MinSize;
+    }
+
+    // pre-condition ! is_unbounded(); never called
+    static constexpr std::size_t maximum_size() noexcept {
+        return ( std::numeric_limits< std::size_t >::max)();
+    }
+};
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+#  include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_STATIC_STACK_TRAITS_H
@@ -0,0 +1,48 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_CONTEXT_TLS_ACCESS_H
+#define BOOST_CONTEXT_TLS_ACCESS_H
+
+#include <boost/config.hpp>
+
+#include <boost/context/detail/config.hpp>
+
+#if defined(BOOST_MSVC)
+# include <intrin.h>
+#endif
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_PREFIX
+#endif
+
+namespace boost {
+namespace context {
+
+// Compilers treat the address of a thread-local variable as invariant inside
+// a function and may keep it in a callee-saved register across a context
+// switch. If the context is resumed on another thread, the cached address
+// still refers to the thread-local storage of the previous thread.
+// tls_access() evaluates `fn` (e.g. `[]() -> T & { return my_tls; }`) out of
+// line and opaque to the optimizer, so the address is computed anew on the
+// thread that is running when tls_access() is called.
+template< typename Fn >
+BOOST_NOINLINE
+auto tls_access( Fn fn) noexcept -> decltype( fn() ) {
+#if defined(BOOST_MSVC)
+    _ReadWriteBarrier();
+#else
+    __asm__ __volatile__ ("" ::: "memory");
+#endif
+    return fn();
+}
+
+}}
+
+#ifdef BOOST_HAS_ABI_HEADERS
+# include BOOST_ABI_SUFFIX
+#endif
+
+#endif // BOOST_CONTEXT_TLS_ACCESS_H
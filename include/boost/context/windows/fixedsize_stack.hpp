@@ -17,6 +17,7 @@ extern "C" {
 
 #include <boost/config.hpp>
 
+#include <boost/context/detail/canary.hpp>
 #include <boost/context/detail/config.hpp>
 #include <boost/context/stack_context.hpp>
 #include <boost/context/stack_traits.hpp>
@@ -57,11 +58,17 @@ public:
         stack_context sctx;
         sctx.size = size__;
         sctx.sp = static_cast< char * >( vp) + sctx.size;
+#if defined(BOOST_USE_STACK_CANARY)
+        sctx.canary = detail::canary_install( vp);
+#endif
         return sctx;
     }
 
     void deallocate( stack_context & sctx) BOOST_NOEXCEPT_OR_NOTHROW {
         BOOST_ASSERT( sctx.sp);
+#if defined(BOOST_USE_STACK_CANARY)
+        detail::canary_verify( sctx);
+#endif
 
         void * vp = static_cast< char * >( sctx.sp) - sctx.size;
         ::VirtualFree( vp, 0, MEM_RELEASE);
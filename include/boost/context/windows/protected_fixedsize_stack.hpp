@@ -11,7 +11,6 @@ extern "C" {
 #include <windows.h>
 }
 
-#include <cmath>
 #include <cstddef>
 #include <new>
 
@@ -42,12 +41,10 @@ public:
 
     stack_context allocate() {
         // page at bottom will be used as guard-page
-        const std::size_t pages(
-            static_cast< std::size_t >( 
-                std::floor(
-                    static_cast< float >( size_) / traits_type::page_size() ) ) );
+        const std::size_t page_size = traits_type::page_size();
+        const std::size_t pages = size_ / page_size;
         BOOST_ASSERT_MSG( 2 <= pages, "at least two pages must fit into stack (one page is guard-page)");
-        const std::size_t size__( pages * traits_type::page_size() );
+        const std::size_t size__( pages * page_size);
         BOOST_ASSERT( 0 != size_ && 0 != size__);
         BOOST_ASSERT( size__ <= size_);
 
@@ -57,10 +54,10 @@ public:
         DWORD old_options;
 #if defined(BOOST_DISABLE_ASSERTS)
         ::VirtualProtect(
-            vp, traits_type::page_size(), PAGE_READWRITE | PAGE_GUARD /*PAGE_NOACCESS*/, & old_options);
+            vp, page_size, PAGE_READWRITE | PAGE_GUARD /*PAGE_NOACCESS*/, & old_options);
 #else
         const BOOL result = ::VirtualProtect(
-            vp, traits_type::page_size(), PAGE_READWRITE | PAGE_GUARD /*PAGE_NOACCESS*/, & old_options);
+            vp, page_size, PAGE_READWRITE | PAGE_GUARD /*PAGE_NOACCESS*/, & old_options);
         BOOST_ASSERT( FALSE != result);
 #endif
 
@@ -0,0 +1,120 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/context/arena.hpp>
+#include <boost/context/continuation.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../clock.hpp"
+
+boost::uint64_t jobs = 100000;
+boost::uint64_t allocs = 16;
+boost::uint64_t threads = 4;
+
+namespace ctx = boost::context;
+
+struct free_store {
+    static void * allocate( std::size_t size) {
+        return ::operator new( size);
+    }
+
+    static void deallocate( void * p, std::size_t) noexcept {
+        ::operator delete( p);
+    }
+};
+
+struct arena {
+    static void * allocate( std::size_t size) {
+        return ctx::arena_allocate( size);
+    }
+
+    static void deallocate( void * p, std::size_t size) noexcept {
+        ctx::arena_deallocate( p, size);
+    }
+};
+
+// each job is a continuation doing `allocs` request-scoped allocations of
+// small objects, all of them released when the job finishes
+template< typename Alloc >
+void worker() {
+    for ( std::size_t i = 0; i < jobs; ++i) {
+        ctx::continuation c = ctx::callcc(
+            []( ctx::continuation && c) {
+                void * p[64];
+                const std::size_t n = allocs < 64 ? allocs : 64;
+                for ( std::size_t j = 0; j < n; ++j) {
+                    p[j] = Alloc::allocate( 16 + 8 * ( j % 8) );
+                    * static_cast< char * >( p[j]) = 0;
+                }
+                for ( std::size_t j = 0; j < n; ++j) {
+                    Alloc::deallocate( p[j], 16 + 8 * ( j % 8) );
+                }
+                return std::move( c);
+            });
+    }
+}
+
+template< typename Alloc >
+duration_type measure() {
+    std::vector< std::thread > ts;
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < threads; ++i) {
+        ts.emplace_back( worker< Alloc >);
+    }
+    for ( std::thread & t : ts) {
+        t.join();
+    }
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= jobs;  // loops
+
+    return total;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("jobs,j", boost::program_options::value< boost::uint64_t >( & jobs), "continuations per thread")
+            ("allocs,a", boost::program_options::value< boost::uint64_t >( & allocs), "allocations per continuation (max. 64)")
+            ("threads,t", boost::program_options::value< boost::uint64_t >( & threads), "threads");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        boost::uint64_t res = measure< free_store >().count();
+        std::cout << "free-store: average of " << res << " nano seconds per continuation" << std::endl;
+        res = measure< arena >().count();
+        std::cout << "arena: average of " << res << " nano seconds per continuation" << std::endl;
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
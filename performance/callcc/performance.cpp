@@ -21,6 +21,29 @@ boost::uint64_t jobs = 1000;
 
 namespace ctx = boost::context;
 
+// hands out the same stack again and again; isolates creating and entering a
+// continuation from the costs of stack allocation
+class reuse_stack {
+private:
+    ctx::stack_context  sctx_;
+
+public:
+    reuse_stack( ctx::stack_context sctx) noexcept :
+        sctx_( sctx) {
+    }
+
+    ctx::stack_context allocate() noexcept {
+        return sctx_;
+    }
+
+    void deallocate( ctx::stack_context &) noexcept {
+    }
+};
+
+static ctx::continuation bar( ctx::continuation && c) {
+    return std::move( c);
+}
+
 static ctx::continuation foo( ctx::continuation && c) {
     while ( true) {
         c = c.resume();
@@ -45,6 +68,26 @@ duration_type measure_time() {
     return total;
 }
 
+// callcc() + entering the context-function + termination
+duration_type measure_create_time() {
+    ctx::fixedsize_stack alloc;
+    ctx::stack_context sctx = alloc.allocate();
+    reuse_stack salloc( sctx);
+    // cache warum-up
+    ctx::continuation c = ctx::callcc( std::allocator_arg, salloc, bar);
+
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < jobs; ++i) {
+        c = ctx::callcc( std::allocator_arg, salloc, bar);
+    }
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= jobs;  // loops
+    alloc.deallocate( sctx);
+
+    return total;
+}
+
 #ifdef BOOST_CONTEXT_CYCLE
 cycle_type measure_cycles() {
     // cache warum-up
@@ -56,7 +99,7 @@ cycle_type measure_cycles() {
     for ( std::size_t i = 0; i < jobs; ++i) {
         c = c.resume();
     }
-    cycle_type total = cycles() - start;
+    cycle_type total = cycles_end() - start;
     total -= overhead_cycle(); // overhead of measurement
     total /= jobs;  // loops
     total /= 2;  // 2x jump_fcontext
@@ -88,12 +131,17 @@ int main( int argc, char * argv[]) {
             return EXIT_SUCCESS;
         }
 
+#if defined(BOOST_USE_STACK_CANARY)
+        std::cout << "stack canary checked at each context switch" << std::endl;
+#endif
         boost::uint64_t res = measure_time().count();
         std::cout << "continuation: average of " << res << " nano seconds" << std::endl;
 #ifdef BOOST_CONTEXT_CYCLE
         res = measure_cycles();
         std::cout << "continuation: average of " << res << " cpu cycles" << std::endl;
 #endif
+        res = measure_create_time().count();
+        std::cout << "callcc() create + first resume: average of " << res << " nano seconds" << std::endl;
 
         return EXIT_SUCCESS;
     } catch ( std::exception const& e) {
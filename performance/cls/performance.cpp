@@ -0,0 +1,146 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/continuation_local.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+
+boost::uint64_t jobs = 1000000;
+boost::uint64_t contexts = 64;
+
+namespace ctx = boost::context;
+
+ctx::continuation_local_ptr< boost::uint64_t > cls_value;
+
+// the former workaround: per-thread map keyed by the context
+thread_local std::unordered_map< void *, boost::uint64_t * > tls_map;
+
+static ctx::continuation foo( ctx::continuation && c) {
+    while ( true) {
+        c = c.resume();
+    }
+    return std::move( c);
+}
+
+duration_type measure_cls() {
+    duration_type total = duration_type::zero();
+    ctx::continuation c = ctx::callcc(
+        [&total]( ctx::continuation && c) {
+            boost::uint64_t value = 1;
+            cls_value.reset( & value);
+            boost::uint64_t sum = 0;
+            time_point_type start( clock_type::now() );
+            for ( std::size_t i = 0; i < jobs; ++i) {
+                sum += * cls_value.get();
+            }
+            total = clock_type::now() - start;
+            if ( jobs != sum) {
+                throw std::logic_error("unexpected value");
+            }
+            return std::move( c);
+        });
+    total -= overhead_clock(); // overhead of measurement
+    total /= jobs;  // loops
+
+    return total;
+}
+
+duration_type measure_map() {
+    duration_type total = duration_type::zero();
+    std::vector< boost::uint64_t > values( contexts, 1);
+    // populate the map as if `contexts` continuations were alive
+    for ( std::size_t i = 0; i < contexts; ++i) {
+        tls_map[& values[i]] = & values[i];
+    }
+    ctx::continuation c = ctx::callcc(
+        [&total,&values]( ctx::continuation && c) {
+            // key of `this` context
+            void * key = & values[0];
+            boost::uint64_t sum = 0;
+            time_point_type start( clock_type::now() );
+            for ( std::size_t i = 0; i < jobs; ++i) {
+                sum += * tls_map.find( key)->second;
+            }
+            total = clock_type::now() - start;
+            if ( jobs != sum) {
+                throw std::logic_error("unexpected value");
+            }
+            return std::move( c);
+        });
+    tls_map.clear();
+    total -= overhead_clock(); // overhead of measurement
+    total /= jobs;  // loops
+
+    return total;
+}
+
+// context switch including save/restore of the active slots
+duration_type measure_switch() {
+    // cache warum-up
+    ctx::continuation c = ctx::callcc( foo);
+    c = c.resume();
+
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < jobs; ++i) {
+        c = c.resume();
+    }
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= jobs;  // loops
+    total /= 2;  // 2x jump_fcontext
+
+    return total;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("jobs,j", boost::program_options::value< boost::uint64_t >( & jobs), "jobs to run")
+            ("contexts,c", boost::program_options::value< boost::uint64_t >( & contexts), "entries in the thread_local map");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        boost::uint64_t res = measure_cls().count();
+        std::cout << "continuation_local_ptr: average of " << res << " nano seconds" << std::endl;
+        res = measure_map().count();
+        std::cout << "thread_local std::unordered_map: average of " << res << " nano seconds" << std::endl;
+        res = measure_switch().count();
+        std::cout << "continuation (with CLS): average of " << res << " nano seconds" << std::endl;
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,286 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// compares two result files written with --json by the performance programs;
+// per benchmark the samples are compared with the Mann-Whitney U test and the
+// shift of the candidate against the baseline is estimated (Hodges-Lehmann)
+// with its confidence interval
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+double alpha = 0.01;
+double threshold = 2;
+std::string filter;
+
+// a benchmark of a result file; entries written without samples (e.g. by
+// performance/soak) can only be compared by their median
+struct result {
+    std::string             name;
+    std::string             unit;
+    double                  median;
+    std::vector< double >   samples;
+};
+
+std::vector< result > load( std::string const& file) {
+    boost::property_tree::ptree pt;
+    boost::property_tree::read_json( file, pt);
+    std::vector< result > results;
+    for ( auto const& b : pt.get_child("benchmarks") ) {
+        result r;
+        r.name = b.second.get< std::string >("name");
+        r.unit = b.second.get< std::string >("unit", "");
+        // null if not finite
+        r.median = b.second.get_optional< double >("median").value_or( NAN);
+        boost::optional< boost::property_tree::ptree const& > samples = b.second.get_child_optional("samples");
+        if ( samples) {
+            for ( auto const& s : * samples) {
+                boost::optional< double > v = s.second.get_value_optional< double >();
+                if ( v) {
+                    r.samples.push_back( * v);
+                }
+            }
+        }
+        results.push_back( r);
+    }
+    return results;
+}
+
+// upper quantile of the standard normal distribution: P(Z > z) = p
+double normal_quantile( double p) {
+    double lo = 0, hi = 40;
+    for ( int i = 0; i < 100; ++i) {
+        const double mid = ( lo + hi) / 2;
+        if ( 0.5 * std::erfc( mid / std::sqrt( 2.) ) > p) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return ( lo + hi) / 2;
+}
+
+// two-sided Mann-Whitney U test, normal approximation with tie and
+// continuity correction
+double mann_whitney_p( std::vector< double > const& x, std::vector< double > const& y) {
+    std::vector< std::pair< double, bool > > all;
+    all.reserve( x.size() + y.size() );
+    for ( double v : x) {
+        all.emplace_back( v, true);
+    }
+    for ( double v : y) {
+        all.emplace_back( v, false);
+    }
+    std::sort( all.begin(), all.end() );
+    const double n1 = static_cast< double >( x.size() );
+    const double n2 = static_cast< double >( y.size() );
+    const double n = n1 + n2;
+    // sum of the ranks of x; tied values get the average of their ranks
+    double r1 = 0, ties = 0;
+    for ( std::size_t i = 0; i < all.size();) {
+        std::size_t j = i;
+        while ( j < all.size() && all[j].first == all[i].first) {
+            ++j;
+        }
+        const double t = static_cast< double >( j - i);
+        const double rank = ( i + 1 + j) / 2.;
+        for ( std::size_t k = i; k < j; ++k) {
+            if ( all[k].second) {
+                r1 += rank;
+            }
+        }
+        ties += t * t * t - t;
+        i = j;
+    }
+    const double u = r1 - n1 * ( n1 + 1) / 2;
+    const double mu = n1 * n2 / 2;
+    const double sigma = std::sqrt( n1 * n2 / 12 * ( ( n + 1) - ties / ( n * ( n - 1) ) ) );
+    if ( 0 == sigma) {
+        return 1;
+    }
+    const double d = std::fabs( u - mu) - 0.5;
+    return ( std::min)( 1., std::erfc( ( std::max)( d, 0.) / sigma / std::sqrt( 2.) ) );
+}
+
+// every `stride`-th value of the sorted samples
+std::vector< double > thin( std::vector< double > v, std::size_t stride) {
+    std::sort( v.begin(), v.end() );
+    std::vector< double > t;
+    for ( std::size_t i = stride / 2; i < v.size(); i += stride) {
+        t.push_back( v[i]);
+    }
+    return t;
+}
+
+// Hodges-Lehmann estimate of the shift y - x: median of all pairwise
+// differences, with the distribution-free confidence interval at level
+// 1 - alpha; large samples are thinned to at most ~10^7 differences
+struct shift {
+    double  estimate;
+    double  lower;
+    double  upper;
+};
+
+shift hodges_lehmann( std::vector< double > x, std::vector< double > y) {
+    const double max_pairs = 1e7;
+    const double pairs = static_cast< double >( x.size() ) * y.size();
+    if ( max_pairs < pairs) {
+        const std::size_t stride = static_cast< std::size_t >( std::ceil( std::sqrt( pairs / max_pairs) ) );
+        x = thin( x, stride);
+        y = thin( y, stride);
+    }
+    std::vector< double > d;
+    d.reserve( x.size() * y.size() );
+    for ( double a : x) {
+        for ( double b : y) {
+            d.push_back( b - a);
+        }
+    }
+    std::sort( d.begin(), d.end() );
+    const double n1 = static_cast< double >( x.size() );
+    const double n2 = static_cast< double >( y.size() );
+    const double nm = n1 * n2;
+    const double k = std::floor( nm / 2 - normal_quantile( alpha / 2) * std::sqrt( nm * ( n1 + n2 + 1) / 12) );
+    const std::size_t lo = static_cast< std::size_t >( ( std::max)( k, 0.) );
+    const std::size_t hi = d.size() - 1 - ( std::min)( lo, d.size() - 1);
+    const std::size_t mid = d.size() / 2;
+    shift s;
+    s.estimate = 0 == d.size() % 2 ? ( d[mid - 1] + d[mid]) / 2 : d[mid];
+    s.lower = d[( std::min)( lo, hi)];
+    s.upper = d[( std::max)( lo, hi)];
+    return s;
+}
+
+std::string percent( double v) {
+    std::ostringstream os;
+    os << std::showpos << std::fixed << std::setprecision( 1) << v << "%";
+    return os.str();
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        std::string baseline_file, candidate_file;
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("baseline", boost::program_options::value< std::string >( & baseline_file), "result file of the reference build")
+            ("candidate", boost::program_options::value< std::string >( & candidate_file), "result file of the build to check")
+            ("alpha,a", boost::program_options::value< double >( & alpha), "significance level (confidence interval at 1 - alpha)")
+            ("threshold,t", boost::program_options::value< double >( & threshold), "smallest change in percent reported as regression or improvement")
+            ("filter,f", boost::program_options::value< std::string >( & filter), "compare benchmarks whose name contains the string");
+        boost::program_options::positional_options_description positional;
+        positional.add("baseline", 1);
+        positional.add("candidate", 1);
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::command_line_parser( argc, argv)
+                    .options( desc)
+                    .positional( positional)
+                    .run(),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") || baseline_file.empty() || candidate_file.empty() ) {
+            std::cout << "usage: compare [options] baseline.json candidate.json\n" << desc << std::endl;
+            return vm.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        if ( 0 >= alpha || 1 <= alpha) {
+            throw std::invalid_argument("alpha must be in (0, 1)");
+        }
+
+        const std::vector< result > baseline = load( baseline_file);
+        const std::vector< result > candidate = load( candidate_file);
+        std::map< std::string, result const* > candidates;
+        for ( result const& r : candidate) {
+            candidates[r.name] = & r;
+        }
+
+        // all units of the performance programs are costs (ns, bytes):
+        // an increase is a regression
+        std::size_t regressions = 0, improvements = 0;
+        std::ostringstream ci;
+        ci << "CI " << std::setprecision( 3) << ( 1 - alpha) * 100 << "%";
+        std::cout << std::setw( 48) << std::left << "benchmark" << std::right
+                  << std::setw( 12) << "baseline" << std::setw( 12) << "candidate"
+                  << std::setw( 9) << "delta" << std::setw( 20) << ci.str()
+                  << std::setw( 10) << "p" << "  verdict" << std::endl;
+        for ( result const& b : baseline) {
+            if ( ! filter.empty() && std::string::npos == b.name.find( filter) ) {
+                continue;
+            }
+            auto it = candidates.find( b.name);
+            if ( candidates.end() == it) {
+                std::cout << std::setw( 48) << std::left << b.name << std::right << "  missing in candidate" << std::endl;
+                continue;
+            }
+            result const& c = * it->second;
+            std::cout << std::setw( 48) << std::left << b.name << std::right
+                      << std::fixed << std::setprecision( 1)
+                      << std::setw( 12) << b.median << std::setw( 12) << c.median;
+            if ( ! std::isfinite( b.median) || ! std::isfinite( c.median) || 0 == b.median) {
+                std::cout << "  not comparable" << std::endl;
+                continue;
+            }
+            if ( b.samples.size() < 2 || c.samples.size() < 2) {
+                // no test possible
+                std::cout << std::setw( 9) << percent( ( c.median - b.median) / b.median * 100)
+                          << std::setw( 30) << "" << "  no samples" << std::endl;
+                continue;
+            }
+            const shift s = hodges_lehmann( b.samples, c.samples);
+            const double p = mann_whitney_p( b.samples, c.samples);
+            const double delta = s.estimate / b.median * 100;
+            char const* verdict = "same";
+            if ( alpha > p && threshold <= std::fabs( delta) ) {
+                if ( 0 < delta) {
+                    verdict = "REGRESSION";
+                    ++regressions;
+                } else {
+                    verdict = "improvement";
+                    ++improvements;
+                }
+            }
+            std::cout << std::setw( 9) << percent( delta)
+                      << std::setw( 20) << "[" + percent( s.lower / b.median * 100) + ", " + percent( s.upper / b.median * 100) + "]"
+                      << std::setw( 10) << std::setprecision( 4) << std::defaultfloat << p
+                      << "  " << verdict << std::endl;
+        }
+        std::set< std::string > baselines;
+        for ( result const& b : baseline) {
+            baselines.insert( b.name);
+        }
+        for ( result const& c : candidate) {
+            if ( 0 == baselines.count( c.name) && ( filter.empty() || std::string::npos != c.name.find( filter) ) ) {
+                std::cout << std::setw( 48) << std::left << c.name << std::right << "  missing in baseline" << std::endl;
+            }
+        }
+        std::cout << regressions << " regressions, " << improvements << " improvements" << std::endl;
+
+        // non-zero if a regression was found, e.g. to fail a CI job
+        return 0 == regressions ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
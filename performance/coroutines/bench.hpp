@@ -0,0 +1,84 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef COROUTINES_BENCH_H
+#define COROUTINES_BENCH_H
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "../clock.hpp"
+#include "../memory.hpp"
+#include "../stats.hpp"
+
+// values per sample (generator, pipeline); ping-pong: round trips per sample
+extern boost::uint64_t items;
+// samples taken per benchmark
+extern boost::uint64_t repetitions;
+// stages of the pipeline
+extern boost::uint64_t stages;
+// instances created per sample to measure the creation cost
+extern boost::uint64_t creations;
+// suspended instances alive at the same time to measure the memory
+extern boost::uint64_t instances;
+// stack size of callcc and ucontext
+extern std::size_t stack_size;
+
+// keeps the compiler from removing the workloads
+extern volatile boost::uint64_t sink;
+
+std::ostream & table();
+
+void add_result( json_report & report, std::string const& mechanism, std::string const& benchmark,
+                 std::string const& unit, std::vector< double > const& samples,
+                 json_report::extra_type const& extra = json_report::extra_type() );
+
+// `fn` performs `ops` operations; each sample is the time per operation in ns
+template< typename Fn >
+std::vector< double > sample( Fn && fn, boost::uint64_t ops) {
+    // warm-up: caches, branch predictors and the pages of the stacks; the
+    // first workload measured in the process would be slower otherwise
+    for ( boost::uint64_t i = 0; i < 1 + repetitions / 10; ++i) {
+        fn();
+    }
+    std::vector< double > samples;
+    samples.reserve( repetitions);
+    for ( boost::uint64_t i = 0; i < repetitions; ++i) {
+        time_point_type start( clock_type::now() );
+        fn();
+        samples.push_back( static_cast< double >( ( clock_type::now() - start).count() ) / ops);
+    }
+    return samples;
+}
+
+// runs `fn` in a child process (POSIX) and returns its result: memory freed
+// by the previous benchmarks and kept by the heap is not reused
+double isolated( std::function< double() > const& fn);
+
+// `make( n)` returns an object owning `n` suspended instances; the growth of
+// the RSS per instance is reported
+template< typename Make >
+double resident_per_instance( Make && make) {
+    return isolated( [&make]() -> double {
+                const std::size_t rss = resident_size();
+                auto holder = make( instances);
+                ( void)holder;
+                const std::size_t now = resident_size();
+                return now > rss ? static_cast< double >( now - rss) / instances : 0;
+            });
+}
+
+// one function per mechanism, each in its own translation unit (the C++20
+// coroutine header is available with C++20 only)
+void measure_callcc( json_report &);
+void measure_coroutine( json_report &);
+void measure_ucontext( json_report &);
+
+#endif // COROUTINES_BENCH_H
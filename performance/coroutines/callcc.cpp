@@ -0,0 +1,127 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+
+#include "bench.hpp"
+
+namespace ctx = boost::context;
+
+// yields 0, 1, 2, ... as data of resume()
+template< typename StackAllocator >
+ctx::continuation make_generator( StackAllocator salloc) {
+    return ctx::callcc( std::allocator_arg, salloc,
+            []( ctx::continuation && c) {
+                for ( boost::uint64_t i = 0;; ++i) {
+                    c = c.resume( i);
+                }
+                return std::move( c);
+            });
+}
+
+template< typename StackAllocator >
+void measure( json_report & report, std::string const& name, StackAllocator salloc) {
+    // ping-pong: two continuations resume each other; a resumes main
+    // after `items` round trips
+    {
+        ctx::continuation b = ctx::callcc( std::allocator_arg, salloc,
+                []( ctx::continuation && a) {
+                    for (;;) {
+                        a = a.resume();
+                    }
+                    return std::move( a);
+                });
+        ctx::continuation a = ctx::callcc( std::allocator_arg, salloc,
+                [&b]( ctx::continuation && m) {
+                    for (;;) {
+                        m = m.resume();
+                        for ( boost::uint64_t i = 0; i < items; ++i) {
+                            b = b.resume();
+                        }
+                    }
+                    return std::move( m);
+                });
+        add_result( report, name, "ping-pong", "ns/hop",
+                    sample( [&a](){
+                                a = a.resume();
+                            }, 2 * items) );
+    }
+    // generator: the consumer resumes the generator for each value
+    {
+        ctx::continuation gen = make_generator( salloc);
+        add_result( report, name, "generator", "ns/item",
+                    sample( [&gen](){
+                                boost::uint64_t sum = 0;
+                                for ( boost::uint64_t i = 0; i < items; ++i) {
+                                    gen = gen.resume();
+                                    sum += gen.get_data< boost::uint64_t >();
+                                }
+                                sink = sum;
+                            }, items) );
+    }
+    // pipeline: each stage pulls a value from the stage before and yields
+    // it incremented; main pulls from the last stage
+    {
+        std::vector< ctx::continuation > cs;
+        cs.reserve( stages);
+        cs.push_back( make_generator( salloc) );
+        for ( std::size_t j = 1; j < stages; ++j) {
+            cs.push_back( ctx::callcc( std::allocator_arg, salloc,
+                    [&cs,j]( ctx::continuation && c) {
+                        for (;;) {
+                            cs[j - 1] = cs[j - 1].resume();
+                            c = c.resume( cs[j - 1].get_data< boost::uint64_t >() + 1);
+                        }
+                        return std::move( c);
+                    }) );
+        }
+        add_result( report, name, "pipeline", "ns/item",
+                    sample( [&cs](){
+                                boost::uint64_t sum = 0;
+                                for ( boost::uint64_t i = 0; i < items; ++i) {
+                                    cs.back() = cs.back().resume();
+                                    sum += cs.back().get_data< boost::uint64_t >();
+                                }
+                                sink = sum;
+                            }, items) );
+        // destroy the consumers first
+        while ( ! cs.empty() ) {
+            cs.pop_back();
+        }
+    }
+    // creation: create, run to the first value, destroy (unwind)
+    add_result( report, name, "create", "ns",
+                sample( [&salloc](){
+                            for ( boost::uint64_t i = 0; i < creations; ++i) {
+                                ctx::continuation gen = make_generator( salloc);
+                            }
+                        }, creations) );
+    // memory of a suspended generator
+    {
+        const double rss = resident_per_instance(
+                [&salloc]( boost::uint64_t n) {
+                    std::vector< ctx::continuation > cs;
+                    cs.reserve( n);
+                    for ( boost::uint64_t i = 0; i < n; ++i) {
+                        cs.push_back( make_generator( salloc) );
+                    }
+                    return cs;
+                });
+        json_report::extra_type extra;
+        extra.emplace_back( "reserved", static_cast< double >( stack_size) );
+        add_result( report, name, "memory", "bytes", std::vector< double >( 1, rss), extra);
+    }
+}
+
+void measure_callcc( json_report & report) {
+    measure( report, "callcc", ctx::fixedsize_stack( stack_size) );
+    measure( report, "callcc/pooled", ctx::pooled_fixedsize_stack( stack_size) );
+}
@@ -0,0 +1,236 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(__has_include)
+# if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#  include <coroutine>
+#  define COROUTINES_CXX20
+# endif
+#endif
+
+#include "bench.hpp"
+
+#if defined(COROUTINES_CXX20)
+// size of the last coroutine frame allocated
+static std::size_t frame_size = 0;
+
+// stackless coroutine; the frame is allocated on the heap
+template< typename Promise >
+class coroutine {
+private:
+    std::coroutine_handle< Promise >    h_;
+
+public:
+    typedef Promise promise_type;
+
+    explicit coroutine( std::coroutine_handle< Promise > h) noexcept :
+        h_( h) {
+    }
+
+    coroutine( coroutine && other) noexcept :
+        h_( std::exchange( other.h_, nullptr) ) {
+    }
+
+    ~coroutine() {
+        if ( h_) {
+            h_.destroy();
+        }
+    }
+
+    coroutine( coroutine const&) = delete;
+    coroutine & operator=( coroutine const&) = delete;
+
+    std::coroutine_handle< Promise > handle() const noexcept {
+        return h_;
+    }
+};
+
+struct promise_base {
+    static void * operator new( std::size_t size) {
+        frame_size = size;
+        return ::operator new( size);
+    }
+
+    static void operator delete( void * p) noexcept {
+        ::operator delete( p);
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    std::suspend_always final_suspend() noexcept {
+        return {};
+    }
+
+    void return_void() noexcept {
+    }
+
+    void unhandled_exception() noexcept {
+        std::terminate();
+    }
+};
+
+struct generator_promise : public promise_base {
+    boost::uint64_t     value{ 0 };
+
+    coroutine< generator_promise > get_return_object() noexcept {
+        return coroutine< generator_promise >{
+            std::coroutine_handle< generator_promise >::from_promise( * this) };
+    }
+
+    std::suspend_always yield_value( boost::uint64_t v) noexcept {
+        value = v;
+        return {};
+    }
+};
+
+typedef coroutine< generator_promise >  generator;
+
+boost::uint64_t next( generator const& g) {
+    g.handle().resume();
+    return g.handle().promise().value;
+}
+
+// yields 0, 1, 2, ...
+generator make_generator() {
+    for ( boost::uint64_t i = 0;; ++i) {
+        co_yield i;
+    }
+}
+
+// yields the values of `prev` incremented
+generator make_stage( generator const& prev) {
+    for (;;) {
+        co_yield next( prev) + 1;
+    }
+}
+
+struct player_promise : public promise_base {
+    coroutine< player_promise > get_return_object() noexcept {
+        return coroutine< player_promise >{
+            std::coroutine_handle< player_promise >::from_promise( * this) };
+    }
+};
+
+typedef coroutine< player_promise >  player;
+
+// symmetric transfer to another coroutine
+struct transfer {
+    std::coroutine_handle<>     to;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend( std::coroutine_handle<>) const noexcept {
+        return to;
+    }
+
+    void await_resume() const noexcept {
+    }
+};
+
+// transfers to `other` until `hops` is exhausted, then returns to the caller
+// of resume()
+player make_player( std::coroutine_handle<> const& other, boost::uint64_t & hops) {
+    for (;;) {
+        if ( 0 == hops) {
+            co_await std::suspend_always{};
+        } else {
+            --hops;
+            co_await transfer{ other };
+        }
+    }
+}
+#endif
+
+void measure_coroutine( json_report & report) {
+#if defined(COROUTINES_CXX20)
+    char const* name = "coroutine";
+    // ping-pong: two coroutines transfer to each other
+    {
+        std::coroutine_handle<> ha, hb;
+        boost::uint64_t hops = 0;
+        player a = make_player( hb, hops);
+        player b = make_player( ha, hops);
+        ha = a.handle();
+        hb = b.handle();
+        add_result( report, name, "ping-pong", "ns/hop",
+                    sample( [&a,&hops](){
+                                hops = 2 * items;
+                                a.handle().resume();
+                            }, 2 * items) );
+    }
+    // generator: the consumer resumes the generator for each value
+    {
+        generator gen = make_generator();
+        add_result( report, name, "generator", "ns/item",
+                    sample( [&gen](){
+                                boost::uint64_t sum = 0;
+                                for ( boost::uint64_t i = 0; i < items; ++i) {
+                                    sum += next( gen);
+                                }
+                                sink = sum;
+                            }, items) );
+    }
+    // pipeline: each stage pulls a value from the stage before and yields
+    // it incremented; main pulls from the last stage
+    {
+        std::vector< generator > gs;
+        gs.reserve( stages);
+        gs.push_back( make_generator() );
+        for ( std::size_t j = 1; j < stages; ++j) {
+            gs.push_back( make_stage( gs[j - 1]) );
+        }
+        add_result( report, name, "pipeline", "ns/item",
+                    sample( [&gs](){
+                                boost::uint64_t sum = 0;
+                                for ( boost::uint64_t i = 0; i < items; ++i) {
+                                    sum += next( gs.back() );
+                                }
+                                sink = sum;
+                            }, items) );
+        while ( ! gs.empty() ) {
+            gs.pop_back();
+        }
+    }
+    // creation: create, run to the first value, destroy
+    add_result( report, name, "create", "ns",
+                sample( [](){
+                            boost::uint64_t sum = 0;
+                            for ( boost::uint64_t i = 0; i < creations; ++i) {
+                                generator gen = make_generator();
+                                sum += next( gen);
+                            }
+                            sink = sum;
+                        }, creations) );
+    // memory of a suspended generator
+    {
+        const double rss = resident_per_instance(
+                []( boost::uint64_t n) {
+                    std::vector< generator > gs;
+                    gs.reserve( n);
+                    for ( boost::uint64_t i = 0; i < n; ++i) {
+                        gs.push_back( make_generator() );
+                        next( gs.back() );
+                    }
+                    return gs;
+                });
+        json_report::extra_type extra;
+        extra.emplace_back( "reserved", static_cast< double >( frame_size) );
+        add_result( report, name, "memory", "bytes", std::vector< double >( 1, rss), extra);
+    }
+#else
+    ( void)report;
+    table() << "C++20 coroutines not supported by the compiler" << std::endl;
+#endif
+}
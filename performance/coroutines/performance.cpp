@@ -0,0 +1,124 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../memory.hpp"
+#include "bench.hpp"
+
+boost::uint64_t items = 10000;
+boost::uint64_t repetitions = 100;
+boost::uint64_t stages = 4;
+boost::uint64_t creations = 1000;
+boost::uint64_t instances = 10000;
+std::size_t stack_size = 16 * 1024;
+std::string json_file;
+
+volatile boost::uint64_t sink = 0;
+
+// the table goes to stderr if stdout carries the JSON report
+std::ostream & table() {
+    return "-" == json_file ? std::cerr : std::cout;
+}
+
+double isolated( std::function< double() > const& fn) {
+    const child_result r = in_child_process( [&fn]( std::ostream & os) {
+                os << std::setprecision( 17) << fn();
+            });
+    std::istringstream is( r.output);
+    double result = 0;
+    if ( ! r.success || ! ( is >> result) ) {
+        throw std::runtime_error("measurement in child process failed");
+    }
+    return result;
+}
+
+void add_result( json_report & report, std::string const& mechanism, std::string const& benchmark,
+                 std::string const& unit, std::vector< double > const& samples,
+                 json_report::extra_type const& extra) {
+    statistics const& s = report.add( "coroutines/" + mechanism + "/" + benchmark, unit, samples, extra);
+    table() << std::left << std::setw( 14) << mechanism << std::setw( 10) << benchmark << std::right
+            << std::fixed << std::setprecision( 1);
+    if ( 1 == s.count) {
+        table() << std::setw( 10) << s.median << " " << unit;
+    } else {
+        table() << " median " << std::setw( 9) << s.median
+                << " p99 " << std::setw( 9) << s.p99 << " " << unit;
+    }
+    for ( auto const& x : extra) {
+        table() << "  " << x.first << " " << std::setprecision( 0) << x.second;
+    }
+    table() << std::endl;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        std::size_t stack_kb = stack_size / 1024;
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("items,n", boost::program_options::value< boost::uint64_t >( & items), "values (generator, pipeline) or round trips (ping-pong) per sample")
+            ("repetitions,r", boost::program_options::value< boost::uint64_t >( & repetitions), "samples per benchmark")
+            ("stages,p", boost::program_options::value< boost::uint64_t >( & stages), "stages of the pipeline")
+            ("creations,c", boost::program_options::value< boost::uint64_t >( & creations), "instances created per sample")
+            ("instances,i", boost::program_options::value< boost::uint64_t >( & instances), "suspended instances to measure the memory")
+            ("stack,s", boost::program_options::value< std::size_t >( & stack_kb), "stack size in KiB (callcc, ucontext)")
+            ("json,o", boost::program_options::value< std::string >( & json_file), "write results as JSON to file ('-' for stdout)");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if ( 0 == items || 0 == repetitions || 0 == stages || 0 == creations || 0 == instances) {
+            throw std::invalid_argument("items, repetitions, stages, creations and instances must not be zero");
+        }
+        stack_size = stack_kb * 1024;
+
+        json_report report;
+        measure_callcc( report);
+        measure_coroutine( report);
+        measure_ucontext( report);
+
+        if ( "-" == json_file) {
+            report.write( std::cout);
+        } else if ( ! json_file.empty() ) {
+            std::ofstream os( json_file.c_str() );
+            if ( ! os) {
+                throw std::runtime_error("can not open " + json_file);
+            }
+            report.write( os);
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,165 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <boost/config.hpp>
+
+#if ! defined(BOOST_WINDOWS)
+# include <ucontext.h>
+#endif
+
+#include "bench.hpp"
+
+#if ! defined(BOOST_WINDOWS)
+// a context and its stack; the functions never return, the stack is freed
+// without unwinding
+class context {
+private:
+    void    *   stack_;
+
+public:
+    ucontext_t  uc;
+
+    context( void (* fn)( int), int arg) :
+        stack_( std::malloc( stack_size) ) {
+        if ( ! stack_) {
+            throw std::bad_alloc();
+        }
+        ::getcontext( & uc);
+        uc.uc_stack.ss_sp = stack_;
+        uc.uc_stack.ss_size = stack_size;
+        uc.uc_link = nullptr;
+        ::makecontext( & uc, reinterpret_cast< void (*)() >( fn), 1, arg);
+    }
+
+    ~context() {
+        std::free( stack_);
+    }
+
+    context( context const&) = delete;
+    context & operator=( context const&) = delete;
+};
+
+static ucontext_t uc_main;
+static std::vector< context * > contexts;
+static std::vector< boost::uint64_t > values;
+static boost::uint64_t hops = 0;
+
+// yields 0, 1, 2, ... via values[0]
+static void generator_fn( int j) {
+    for ( boost::uint64_t i = 0;; ++i) {
+        values[0] = i;
+        ::swapcontext( & contexts[j]->uc, & uc_main);
+    }
+}
+
+// stage 0 yields 0, 1, 2, ...; stage j pulls from stage j - 1 and yields
+// the value incremented to stage j + 1 (the last stage to main)
+static void stage_fn( int j) {
+    for ( boost::uint64_t i = 0;; ++i) {
+        if ( 0 == j) {
+            values[0] = i;
+        } else {
+            ::swapcontext( & contexts[j]->uc, & contexts[j - 1]->uc);
+            values[j] = values[j - 1] + 1;
+        }
+        ::swapcontext( & contexts[j]->uc,
+                       stages == static_cast< boost::uint64_t >( j + 1) ? & uc_main : & contexts[j + 1]->uc);
+    }
+}
+
+// switches to the other player until `hops` is exhausted, then to main
+static void player_fn( int j) {
+    for (;;) {
+        if ( 0 == hops) {
+            ::swapcontext( & contexts[j]->uc, & uc_main);
+        } else {
+            --hops;
+            ::swapcontext( & contexts[j]->uc, & contexts[1 - j]->uc);
+        }
+    }
+}
+
+static void clear() {
+    for ( context * c : contexts) {
+        delete c;
+    }
+    contexts.clear();
+}
+#endif
+
+void measure_ucontext( json_report & report) {
+#if ! defined(BOOST_WINDOWS)
+    char const* name = "ucontext";
+    values.assign( stages, 0);
+    // ping-pong: two contexts switch to each other
+    contexts.push_back( new context( player_fn, 0) );
+    contexts.push_back( new context( player_fn, 1) );
+    add_result( report, name, "ping-pong", "ns/hop",
+                sample( [](){
+                            hops = 2 * items;
+                            ::swapcontext( & uc_main, & contexts[0]->uc);
+                        }, 2 * items) );
+    clear();
+    // generator: the consumer resumes the generator for each value
+    contexts.push_back( new context( generator_fn, 0) );
+    ::swapcontext( & uc_main, & contexts[0]->uc);
+    add_result( report, name, "generator", "ns/item",
+                sample( [](){
+                            boost::uint64_t sum = 0;
+                            for ( boost::uint64_t i = 0; i < items; ++i) {
+                                ::swapcontext( & uc_main, & contexts[0]->uc);
+                                sum += values[0];
+                            }
+                            sink = sum;
+                        }, items) );
+    clear();
+    // pipeline: each stage pulls a value from the stage before and yields
+    // it incremented; main pulls from the last stage
+    for ( boost::uint64_t j = 0; j < stages; ++j) {
+        contexts.push_back( new context( stage_fn, static_cast< int >( j) ) );
+    }
+    add_result( report, name, "pipeline", "ns/item",
+                sample( [](){
+                            boost::uint64_t sum = 0;
+                            for ( boost::uint64_t i = 0; i < items; ++i) {
+                                ::swapcontext( & uc_main, & contexts.back()->uc);
+                                sum += values.back();
+                            }
+                            sink = sum;
+                        }, items) );
+    clear();
+    // creation: create, run to the first value, destroy
+    add_result( report, name, "create", "ns",
+                sample( [](){
+                            for ( boost::uint64_t i = 0; i < creations; ++i) {
+                                contexts.push_back( new context( generator_fn, 0) );
+                                ::swapcontext( & uc_main, & contexts[0]->uc);
+                                clear();
+                            }
+                        }, creations) );
+    // memory of a suspended generator
+    {
+        const double rss = resident_per_instance(
+                []( boost::uint64_t n) {
+                    contexts.reserve( n);
+                    for ( boost::uint64_t i = 0; i < n; ++i) {
+                        contexts.push_back( new context( generator_fn, static_cast< int >( i) ) );
+                        ::swapcontext( & uc_main, & contexts.back()->uc);
+                    }
+                    return n;
+                });
+        clear();
+        json_report::extra_type extra;
+        extra.emplace_back( "reserved", static_cast< double >( stack_size + sizeof( context) ) );
+        add_result( report, name, "memory", "bytes", std::vector< double >( 1, rss), extra);
+    }
+#else
+    ( void)report;
+#endif
+}
@@ -20,7 +20,12 @@
 
 typedef boost::uint64_t cycle_type;
 
+// cycles_end() uses `rdtscp`, which waits until all preceding instructions
+// have executed; the trailing `lfence` keeps following instructions from
+// starting before the counter is read
 #if _MSC_VER
+# include <intrin.h>
+# pragma intrinsic(__rdtscp)
 inline
 cycle_type cycles()
 {
@@ -33,6 +38,15 @@ cycle_type cycles()
     }
     return c;
 }
+
+inline
+cycle_type cycles_end()
+{
+    unsigned int aux;
+    cycle_type c = __rdtscp( & aux);
+    _mm_lfence();
+    return c;
+}
 #elif defined(__GNUC__) || \
       defined(__INTEL_COMPILER) || defined(__ICC) || defined(_ECC) || defined(__ICL)
 inline
@@ -54,6 +68,22 @@ cycle_type cycles()
 
     return ( cycle_type)hi << 32 | lo; 
 }
+
+inline
+cycle_type cycles_end()
+{
+    boost::uint32_t lo, hi;
+
+    __asm__ __volatile__ (
+        "rdtscp\n"
+        "lfence\n"
+        : "=a" (lo), "=d" (hi)
+        :
+        : "%ecx", "memory"
+    );
+
+    return ( cycle_type)hi << 32 | lo;
+}
 #else
 # error "this compiler is not supported"
 #endif
@@ -63,7 +93,7 @@ struct cycle_overhead
     cycle_type operator()()
     {
         cycle_type start( cycles() );
-        return cycles() - start;
+        return cycles_end() - start;
     }
 };
 
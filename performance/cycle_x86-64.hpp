@@ -20,16 +20,51 @@
 
 typedef boost::uint64_t cycle_type;
 
+// cycles() reads the time-stamp counter fenced by `lfence`, so it is neither
+// executed before preceding nor after following instructions; `cpuid` used to
+// serialize costs more than 100 cycles, much more than a context switch.
+// cycles_end() uses `rdtscp`, which waits until all preceding instructions
+// have executed.
 #if _MSC_VER >= 1400
 # include <intrin.h>
 # pragma intrinsic(__rdtsc)
+# pragma intrinsic(__rdtscp)
 inline
 cycle_type cycles()
-{ return __rdtsc(); }
+{
+    _mm_lfence();
+    cycle_type c = __rdtsc();
+    _mm_lfence();
+    return c;
+}
+
+inline
+cycle_type cycles_end()
+{
+    unsigned int aux;
+    cycle_type c = __rdtscp( & aux);
+    _mm_lfence();
+    return c;
+}
 #elif defined(__INTEL_COMPILER) || defined(__ICC) || defined(_ECC) || defined(__ICL)
+# include <immintrin.h>
 inline
 cycle_type cycles()
-{ return __rdtsc(); }
+{
+    _mm_lfence();
+    cycle_type c = __rdtsc();
+    _mm_lfence();
+    return c;
+}
+
+inline
+cycle_type cycles_end()
+{
+    unsigned int aux;
+    cycle_type c = __rdtscp( & aux);
+    _mm_lfence();
+    return c;
+}
 #elif defined(__GNUC__) || defined(__SUNPRO_C)
 inline
 cycle_type cycles()
@@ -37,18 +72,31 @@ cycle_type cycles()
     boost::uint32_t lo, hi;
 
     __asm__ __volatile__ (
-        "xorl %%eax, %%eax\n"
-        "cpuid\n"
-        ::: "%rax", "%rbx", "%rcx", "%rdx"
+        "lfence\n"
+        "rdtsc\n"
+        "lfence\n"
+        : "=a" (lo), "=d" (hi)
+        :
+        : "memory"
     );
-    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi) );
+
+    return ( cycle_type)hi << 32 | lo;
+}
+
+inline
+cycle_type cycles_end()
+{
+    boost::uint32_t lo, hi;
+
     __asm__ __volatile__ (
-        "xorl %%eax, %%eax\n"
-        "cpuid\n"
-        ::: "%rax", "%rbx", "%rcx", "%rdx"
+        "rdtscp\n"
+        "lfence\n"
+        : "=a" (lo), "=d" (hi)
+        :
+        : "%rcx", "memory"
     );
 
-    return ( cycle_type)hi << 32 | lo; 
+    return ( cycle_type)hi << 32 | lo;
 }
 #else
 # error "this compiler is not supported"
@@ -59,7 +107,7 @@ struct cycle_overhead
     cycle_type operator()()
     {
         cycle_type start( cycles() );
-        return cycles() - start;
+        return cycles_end() - start;
     }
 };
 
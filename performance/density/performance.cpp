@@ -0,0 +1,254 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// memory consumed by suspended continuations; POSIX only, RSS and VSZ are
+// read from /proc/self/statm (Linux)
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/context/segmented_stack.hpp>
+#include <boost/context/slab_protected_stack.hpp>
+#include <boost/context/stack_traits.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+#include "../memory.hpp"
+#include "../stats.hpp"
+
+namespace ctx = boost::context;
+
+std::string counts_list = "10000,100000,1000000";
+boost::uint64_t small_kb = 16;
+boost::uint64_t large_kb = ctx::stack_traits::default_size() / 1024;
+boost::uint64_t rss_limit_mb = 0;
+std::string allocator_name;
+std::string json_file;
+
+std::vector< boost::uint64_t > counts;
+
+// extra values of an entry, in the order measure() writes them
+char const* const fields[] = {
+    "continuations", "rss", "vsz", "vmas", "per_gib", "creation_rate", "complete" };
+
+// memory of the process in bytes
+struct memory {
+    std::size_t     vsz{ 0 };
+    std::size_t     rss{ 0 };
+    std::size_t     vmas{ 0 };
+};
+
+memory sample_memory() {
+    memory m;
+    std::ifstream is("/proc/self/statm");
+    std::size_t size = 0, resident = 0;
+    if ( is >> size >> resident) {
+        const std::size_t page_size = ctx::stack_traits::page_size();
+        m.vsz = size * page_size;
+        m.rss = resident * page_size;
+    }
+    m.vmas = ctx::process_vma_count();
+    return m;
+}
+
+static ctx::continuation suspended( ctx::continuation && c) {
+    return c.resume();
+}
+
+std::ostream & table() {
+    return "-" == json_file ? std::cerr : std::cout;
+}
+
+// creates suspended continuations until the largest count is reached,
+// allocation fails or the RSS exceeds the limit; reports the growth of the
+// process at each count; one line per entry is written to `results`: name,
+// value and the extra values listed in `fields`
+template< typename StackAllocator >
+void measure( std::ostream & results, std::string const& name, std::size_t stack_size, StackAllocator salloc) {
+    std::ostringstream label;
+    label << name << "/" << stack_size / 1024 << "KiB";
+    const memory base = sample_memory();
+    const std::size_t limit = rss_limit( base.rss, rss_limit_mb);
+    std::vector< ctx::continuation > cs;
+    cs.reserve( counts.back() );
+    std::string stopped;
+    time_point_type start( clock_type::now() );
+    for ( boost::uint64_t count : counts) {
+        try {
+            while ( cs.size() < count) {
+                cs.push_back( ctx::make_continuation( std::allocator_arg, salloc, suspended) );
+                if ( 0 == ( cs.size() % 1024) && 0 != limit && resident_size() > limit) {
+                    stopped = "RSS limit reached";
+                    break;
+                }
+            }
+        } catch ( std::bad_alloc const&) {
+            stopped = "allocation failed";
+        }
+        duration_type elapsed = clock_type::now() - start;
+        const memory m = sample_memory();
+        const double n = static_cast< double >( cs.size() );
+        const double rss = static_cast< double >( m.rss - ( std::min)( base.rss, m.rss) );
+        const double vsz = static_cast< double >( m.vsz - ( std::min)( base.vsz, m.vsz) );
+        const double vmas = static_cast< double >( m.vmas - ( std::min)( base.vmas, m.vmas) );
+        const double rate = 0 < elapsed.count() ? n * 1e9 / elapsed.count() : 0;
+        const double per_gib = 0 < rss ? n * 1024 * 1024 * 1024 / rss : 0;
+        table() << std::setw( 34) << std::left << label.str() << std::right
+                << std::setw( 9) << cs.size()
+                << std::fixed << std::setprecision( 0)
+                << std::setw( 11) << rss / 1024 / 1024 << " MiB RSS"
+                << std::setw( 10) << vsz / 1024 / 1024 << " MiB VSZ"
+                << std::setw( 9) << vmas << " VMAs"
+                << std::setw( 8) << rss / ( std::max)( n, 1.0) << " B/ctx"
+                << std::setw( 10) << per_gib << " ctx/GiB"
+                << std::setw( 10) << rate << " ctx/s";
+        if ( ! stopped.empty() ) {
+            table() << "  (" << stopped << ")";
+        }
+        table() << std::endl;
+        std::ostringstream entry;
+        entry << "density/" << label.str() << "/" << count;
+        results << std::setprecision( 17) << entry.str() << ' ' << rss / ( std::max)( n, 1.0)
+                << ' ' << n << ' ' << rss << ' ' << vsz << ' ' << vmas
+                << ' ' << per_gib << ' ' << rate << ' ' << ( stopped.empty() ? 1 : 0) << '\n';
+        if ( ! stopped.empty() ) {
+            break;
+        }
+    }
+    // destroying the suspended continuations unwinds their stacks
+}
+
+// runs measure() in a child process: memory freed by a previously measured
+// allocator (kept by the heap or a pool) would otherwise be reused and
+// distort the growth of the process; the entries are passed through a pipe
+template< typename StackAllocator >
+void isolated( json_report & report, std::string const& name, std::size_t stack_size, StackAllocator salloc) {
+    if ( ! allocator_name.empty() && allocator_name != name) {
+        return;
+    }
+    const child_result r = in_child_process( [&]( std::ostream & results) {
+                measure( results, name, stack_size, salloc);
+            });
+    if ( 0 != r.signal) {
+        // e.g. killed by the OOM killer; the entries written so far are kept
+        table() << name << "/" << stack_size / 1024 << "KiB: terminated by signal " << r.signal << std::endl;
+    }
+    std::istringstream is( r.output);
+    std::string line;
+    while ( std::getline( is, line) ) {
+        std::istringstream ls( line);
+        std::string entry;
+        double value = 0;
+        if ( ! ( ls >> entry >> value) ) {
+            continue;
+        }
+        json_report::extra_type extra;
+        for ( char const* field : fields) {
+            double v = 0;
+            ls >> v;
+            extra.emplace_back( field, v);
+        }
+        report.add( entry, "bytes RSS per continuation", std::vector< double >( 1, value), extra);
+    }
+}
+
+std::vector< boost::uint64_t > parse_counts( std::string const& str) {
+    std::vector< boost::uint64_t > v;
+    std::istringstream is( str);
+    std::string item;
+    while ( std::getline( is, item, ',') ) {
+        std::istringstream iss( item);
+        boost::uint64_t n = 0;
+        if ( ! ( iss >> n) || 0 == n) {
+            throw std::invalid_argument("invalid list of counts: " + str);
+        }
+        v.push_back( n);
+    }
+    if ( v.empty() ) {
+        throw std::invalid_argument("invalid list of counts: " + str);
+    }
+    std::sort( v.begin(), v.end() );
+    return v;
+}
+
+void measure_all( json_report & report, std::size_t stack_size) {
+    isolated( report, "protected_fixedsize_stack", stack_size, ctx::protected_fixedsize_stack( stack_size) );
+    isolated( report, "slab_protected_stack", stack_size, ctx::slab_protected_stack( stack_size) );
+#if defined(BOOST_USE_SEGMENTED_STACKS)
+    isolated( report, "segmented_stack", stack_size, ctx::segmented_stack( stack_size) );
+#endif
+    isolated( report, "pooled_fixedsize_stack", stack_size, ctx::pooled_fixedsize_stack( stack_size) );
+    isolated( report, "fixedsize_stack", stack_size, ctx::fixedsize_stack( stack_size) );
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("counts,n", boost::program_options::value< std::string >( & counts_list), "comma separated numbers of continuations to report")
+            ("small,s", boost::program_options::value< boost::uint64_t >( & small_kb), "small stack size in KiB")
+            ("large,l", boost::program_options::value< boost::uint64_t >( & large_kb), "large stack size in KiB")
+            ("allocator,a", boost::program_options::value< std::string >( & allocator_name), "measure only this allocator")
+            ("rss-limit,m", boost::program_options::value< boost::uint64_t >( & rss_limit_mb), "stop creating at this RSS in MiB (default: half of the free memory)")
+            ("json,o", boost::program_options::value< std::string >( & json_file), "write results as JSON to file ('-' for stdout)");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        counts = parse_counts( counts_list);
+
+        table() << "limit of VMAs: " << ctx::max_vma_count() << std::endl;
+        json_report report;
+        measure_all( report, small_kb * 1024);
+        if ( large_kb != small_kb) {
+            measure_all( report, large_kb * 1024);
+        }
+
+        if ( "-" == json_file) {
+            report.write( std::cout);
+        } else if ( ! json_file.empty() ) {
+            std::ofstream os( json_file.c_str() );
+            if ( ! os) {
+                throw std::runtime_error("can not open " + json_file);
+            }
+            report.write( os);
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -8,14 +8,17 @@
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
 #include <boost/context/all.hpp>
+#include <boost/context/detail/jump_preserve_none.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/program_options.hpp>
 
 #include "../bind_processor.hpp"
 #include "../clock.hpp"
 #include "../cycle.hpp"
+#include "../perf_event.hpp"
 
 template< std::size_t Max, std::size_t Default, std::size_t Min >
 class simple_stack_allocator
@@ -58,26 +61,50 @@ typedef simple_stack_allocator<
 
 boost::uint64_t jobs = 1000;
 
+typedef boost::context::detail::transfer_t ( * jump_type)( boost::context::detail::fcontext_t const, void *);
+
+typedef boost::context::detail::transfer_t ( * switch_type)( boost::context::detail::fcontext_t);
+
+// tight loop; the switch is inlined into the loop
+template< jump_type Jump >
+BOOST_FORCEINLINE
+boost::context::detail::transfer_t direct( boost::context::detail::fcontext_t fctx) {
+    return Jump( fctx, 0);
+}
+
+// each switch is followed by a return, as in code where the switch is
+// wrapped by a function (e.g. resume())
+template< jump_type Jump >
+BOOST_NOINLINE
+boost::context::detail::transfer_t wrapped( boost::context::detail::fcontext_t fctx) {
+    boost::context::detail::transfer_t t = Jump( fctx, 0);
+    // prevent a tail-call
+    __asm__ __volatile__ ("" ::: "memory");
+    return t;
+}
+
+template< switch_type Switch >
 static void foo( boost::context::detail::transfer_t t_) {
     boost::context::detail::transfer_t t = t_;
     while ( true) {
-        t = boost::context::detail::jump_fcontext( t.fctx, 0);
+        t = Switch( t.fctx);
     }
 }
 
+template< switch_type Switch >
 duration_type measure_time_fc() {
     stack_allocator stack_alloc;
     boost::context::detail::fcontext_t ctx = boost::context::detail::make_fcontext(
             stack_alloc.allocate( stack_allocator::default_stacksize() ),
             stack_allocator::default_stacksize(),
-            foo);
+            foo< Switch >);
 
     // cache warum-up
-    boost::context::detail::transfer_t t = boost::context::detail::jump_fcontext( ctx, 0);
+    boost::context::detail::transfer_t t = Switch( ctx);
 
     time_point_type start( clock_type::now() );
     for ( std::size_t i = 0; i < jobs; ++i) {
-        t = boost::context::detail::jump_fcontext( t.fctx, 0);
+        t = Switch( t.fctx);
     }
     duration_type total = clock_type::now() - start;
     total -= overhead_clock(); // overhead of measurement
@@ -88,21 +115,22 @@ duration_type measure_time_fc() {
 }
 
 #ifdef BOOST_CONTEXT_CYCLE
+template< switch_type Switch >
 cycle_type measure_cycles_fc() {
     stack_allocator stack_alloc;
     boost::context::detail::fcontext_t ctx = boost::context::detail::make_fcontext(
             stack_alloc.allocate( stack_allocator::default_stacksize() ),
             stack_allocator::default_stacksize(),
-            foo);
+            foo< Switch >);
 
     // cache warum-up
-    boost::context::detail::transfer_t t = boost::context::detail::jump_fcontext( ctx, 0);
+    boost::context::detail::transfer_t t = Switch( ctx);
 
     cycle_type start( cycles() );
     for ( std::size_t i = 0; i < jobs; ++i) {
-        t = boost::context::detail::jump_fcontext( t.fctx, 0);
+        t = Switch( t.fctx);
     }
-    cycle_type total = cycles() - start;
+    cycle_type total = cycles_end() - start;
     total -= overhead_cycle(); // overhead of measurement
     total /= jobs;  // loops
     total /= 2;  // 2x jump_fcontext
@@ -111,6 +139,48 @@ cycle_type measure_cycles_fc() {
 }
 #endif
 
+// mispredicted branches per switch; 0 if hardware counters are not available
+template< switch_type Switch >
+double measure_branch_misses_fc() {
+    stack_allocator stack_alloc;
+    boost::context::detail::fcontext_t ctx = boost::context::detail::make_fcontext(
+            stack_alloc.allocate( stack_allocator::default_stacksize() ),
+            stack_allocator::default_stacksize(),
+            foo< Switch >);
+
+    // cache warum-up
+    boost::context::detail::transfer_t t = Switch( ctx);
+
+    perf_counter counter( perf_counter::branch_misses);
+    counter.start();
+    for ( std::size_t i = 0; i < jobs; ++i) {
+        t = Switch( t.fctx);
+    }
+    counter.stop();
+
+    return static_cast< double >( counter.value() ) / jobs / 2;  // 2x jump_fcontext
+}
+
+template< switch_type Switch >
+void report_switch( std::string const& name) {
+    boost::uint64_t res = measure_time_fc< Switch >().count();
+    std::cout << name << ": average of " << res << " nano seconds" << std::endl;
+#ifdef BOOST_CONTEXT_CYCLE
+    res = measure_cycles_fc< Switch >();
+    std::cout << name << ": average of " << res << " cpu cycles" << std::endl;
+#endif
+    if ( perf_counter( perf_counter::branch_misses).valid() ) {
+        std::cout << name << ": average of " << measure_branch_misses_fc< Switch >()
+                  << " branch misses" << std::endl;
+    }
+}
+
+template< jump_type Jump >
+void report( std::string const& name) {
+    report_switch< direct< Jump > >( name);
+    report_switch< wrapped< Jump > >( name + " wrapped");
+}
+
 int main( int argc, char * argv[])
 {
     try
@@ -136,11 +206,12 @@ int main( int argc, char * argv[])
             return EXIT_SUCCESS;
         }
 
-        boost::uint64_t res = measure_time_fc().count();
-        std::cout << "fcontext_t: average of " << res << " nano seconds" << std::endl;
-#ifdef BOOST_CONTEXT_CYCLE
-        res = measure_cycles_fc();
-        std::cout << "fcontext_t: average of " << res << " cpu cycles" << std::endl;
+        report< boost::context::detail::jump_fcontext >("fcontext_t");
+#if defined(BOOST_CONTEXT_HAS_JUMP_RET)
+        report< boost::context::detail::jump_fcontext_ret >("fcontext_t (ret)");
+#endif
+#if defined(BOOST_CONTEXT_HAS_JUMP_MINIMAL)
+        report< boost::context::detail::jump_fcontext_minimal >("fcontext_t (preserve_none)");
 #endif
 
         return EXIT_SUCCESS;
@@ -0,0 +1,44 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <utility>
+
+#include <boost/context/continuation.hpp>
+
+#include "footprint.hpp"
+
+namespace ctx = boost::context;
+
+static ctx::continuation loop( ctx::continuation && c) {
+    while ( true) {
+        c = c.resume();
+        trace_mark();
+    }
+    return std::move( c);
+}
+
+void measure_callcc( json_report & report) {
+    traced_stack salloc;
+    // switch to a suspended continuation and back
+    {
+        ctx::continuation c = ctx::callcc( std::allocator_arg, salloc, loop);
+        sample( report, "callcc", { "switch-to", "switch-back" },
+                [&c](){
+                    trace_begin();
+                    c = c.resume();
+                    trace_end();
+                }, "round-trip");
+    }
+    // create: callcc() runs the continuation until it suspends; destroy:
+    // unwind the suspended continuation and deallocate its stack
+    sample( report, "callcc", { "create", "destroy" },
+            [&salloc](){
+                trace_begin();
+                ctx::continuation c = ctx::callcc( std::allocator_arg, salloc, loop);
+                trace_mark();
+                c = ctx::continuation{};
+                trace_end();
+            }, "create-destroy");
+}
@@ -0,0 +1,88 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <utility>
+
+#include <boost/context/execution_context.hpp>
+
+#include "footprint.hpp"
+
+namespace ctx = boost::context;
+
+#if defined(BOOST_EXECUTION_CONTEXT) && (BOOST_EXECUTION_CONTEXT == 1)
+// execution_context v1 requires the library built with
+// BOOST_EXECUTION_CONTEXT=1; v1 and v2 are mutually exclusive
+static ctx::execution_context * mctx = nullptr;
+
+static void loop( void *) {
+    while ( true) {
+        ( * mctx)();
+        trace_mark();
+    }
+}
+
+void measure_execution_context( json_report & report) {
+    traced_stack salloc;
+    ctx::execution_context m = ctx::execution_context::current();
+    mctx = & m;
+    // switch to a suspended context and back
+    {
+        ctx::execution_context c( std::allocator_arg, salloc, loop);
+        c();
+        sample( report, "ecv1", { "switch-to", "switch-back" },
+                [&c](){
+                    trace_begin();
+                    c();
+                    trace_end();
+                }, "round-trip");
+    }
+    // create: construct and resume the context until it suspends; destroy:
+    // release the suspended context
+    sample( report, "ecv1", { "create", "destroy" },
+            [&salloc](){
+                trace_begin();
+                {
+                    ctx::execution_context c( std::allocator_arg, salloc, loop);
+                    c();
+                    trace_mark();
+                }
+                trace_end();
+            }, "create-destroy");
+}
+#else
+static ctx::execution_context< void > loop( ctx::execution_context< void > && c) {
+    while ( true) {
+        c = c();
+        trace_mark();
+    }
+    return std::move( c);
+}
+
+void measure_execution_context( json_report & report) {
+    traced_stack salloc;
+    // switch to a suspended context and back
+    {
+        ctx::execution_context< void > c( std::allocator_arg, salloc, loop);
+        c = c();
+        sample( report, "ecv2", { "switch-to", "switch-back" },
+                [&c](){
+                    trace_begin();
+                    c = c();
+                    trace_end();
+                }, "round-trip");
+    }
+    // create: construct and resume the context until it suspends; destroy:
+    // unwind the suspended context and deallocate its stack
+    sample( report, "ecv2", { "create", "destroy" },
+            [&salloc](){
+                trace_begin();
+                ctx::execution_context< void > c( std::allocator_arg, salloc, loop);
+                c = c();
+                trace_mark();
+                c = ctx::execution_context< void >{};
+                trace_end();
+            }, "create-destroy");
+}
+#endif
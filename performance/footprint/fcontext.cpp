@@ -0,0 +1,47 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/context/detail/fcontext.hpp>
+
+#include "footprint.hpp"
+
+namespace ctx = boost::context;
+
+static void loop( ctx::detail::transfer_t t) {
+    while ( true) {
+        t = ctx::detail::jump_fcontext( t.fctx, 0);
+        trace_mark();
+    }
+}
+
+void measure_fcontext( json_report & report) {
+    traced_stack salloc;
+    // switch to a suspended context and back
+    {
+        ctx::stack_context sctx = salloc.allocate();
+        ctx::detail::transfer_t t = ctx::detail::jump_fcontext(
+                ctx::detail::make_fcontext( sctx.sp, sctx.size, loop), 0);
+        sample( report, "fcontext", { "switch-to", "switch-back" },
+                [&t](){
+                    trace_begin();
+                    t = ctx::detail::jump_fcontext( t.fctx, 0);
+                    trace_end();
+                }, "round-trip");
+        // `loop` never returns; its stack is released without unwinding
+        salloc.deallocate( sctx);
+    }
+    // create: allocate the stack, make_fcontext() and jump into the context
+    // until it suspends; destroy: deallocate the stack
+    sample( report, "fcontext", { "create", "destroy" },
+            [&salloc](){
+                trace_begin();
+                ctx::stack_context sctx = salloc.allocate();
+                ctx::detail::jump_fcontext(
+                    ctx::detail::make_fcontext( sctx.sp, sctx.size, loop), 0);
+                trace_mark();
+                salloc.deallocate( sctx);
+                trace_end();
+            }, "create-destroy");
+}
@@ -0,0 +1,388 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "footprint.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/context/detail/fcontext.hpp>
+
+#if defined(BOOST_CONTEXT_FOOTPRINT)
+extern "C" {
+# include <signal.h>
+# include <sys/mman.h>
+# include <ucontext.h>
+# include <unistd.h>
+}
+#endif
+
+namespace ctx = boost::context;
+
+volatile std::sig_atomic_t recording = 0;
+volatile std::size_t access_count = 0;
+volatile std::size_t marks[max_marks];
+volatile std::size_t mark_count = 0;
+
+namespace {
+
+// x86 trap flag: the CPU raises SIGTRAP after the next instruction
+const long trap_flag = 0x100;
+// x86 page fault error code: write access
+const long write_access = 0x2;
+
+struct region {
+    boost::uintptr_t            base;
+    std::size_t                 size;
+    char const*                 kind;
+    volatile std::sig_atomic_t  active;
+};
+
+const std::size_t max_regions = 64;
+region regions[max_regions];
+volatile std::size_t region_count = 0;
+
+// one entry per access to a traced stack
+struct touch {
+    boost::uintptr_t    addr;
+    // distance of the line to the top of the stack
+    std::size_t         offset;
+    char const*         kind;
+    bool                write;
+};
+
+const std::size_t max_accesses = 1 << 20;
+touch accesses[max_accesses];
+volatile std::sig_atomic_t overflow = 0;
+
+// the stacks are protected (set before protecting, reset before unprotecting)
+volatile std::sig_atomic_t armed = 0;
+
+// pages made accessible for the instruction being single-stepped
+const std::size_t max_stepping = 8;
+boost::uintptr_t stepping[max_stepping];
+volatile std::size_t stepping_count = 0;
+
+std::size_t page_size() {
+#if defined(BOOST_CONTEXT_FOOTPRINT)
+    static const std::size_t size = static_cast< std::size_t >( ::sysconf( _SC_PAGESIZE) );
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+std::size_t line_size() {
+#if defined(BOOST_CONTEXT_FOOTPRINT) && defined(_SC_LEVEL1_DCACHE_LINESIZE)
+    static const long size = ::sysconf( _SC_LEVEL1_DCACHE_LINESIZE);
+    return 0 < size ? static_cast< std::size_t >( size) : 64;
+#else
+    return 64;
+#endif
+}
+
+region const* find( boost::uintptr_t addr) {
+    for ( std::size_t i = 0; i < region_count; ++i) {
+        if ( regions[i].active && regions[i].base <= addr && addr < regions[i].base + regions[i].size) {
+            return & regions[i];
+        }
+    }
+    return nullptr;
+}
+
+#if defined(BOOST_CONTEXT_FOOTPRINT)
+void protect( boost::uintptr_t addr, std::size_t size, bool on) {
+    ::mprotect( reinterpret_cast< void * >( addr), size, on ? PROT_NONE : PROT_READ | PROT_WRITE);
+}
+
+void on_fault( int, siginfo_t * info, void * context) {
+    const boost::uintptr_t addr = reinterpret_cast< boost::uintptr_t >( info->si_addr);
+    region const* r = find( addr);
+    if ( nullptr == r || max_stepping == stepping_count) {
+        // not caused by tracing: fault again with the default action
+        struct sigaction sa;
+        sa.sa_handler = SIG_DFL;
+        sa.sa_flags = 0;
+        ::sigemptyset( & sa.sa_mask);
+        ::sigaction( SIGSEGV, & sa, nullptr);
+        return;
+    }
+    const boost::uintptr_t page = addr & ~( page_size() - 1);
+    protect( page, page_size(), false);
+    if ( ! armed) {
+        // disarm() is in progress
+        return;
+    }
+    ucontext_t * uc = static_cast< ucontext_t * >( context);
+    if ( recording) {
+        if ( max_accesses > access_count) {
+            const boost::uintptr_t line = addr & ~( line_size() - 1);
+            touch & a = accesses[access_count];
+            a.addr = addr;
+            a.offset = r->base + r->size - line;
+            a.kind = r->kind;
+            a.write = 0 != ( uc->uc_mcontext.gregs[REG_ERR] & write_access);
+            access_count = access_count + 1;
+        } else {
+            overflow = 1;
+        }
+    }
+    stepping[stepping_count] = page;
+    stepping_count = stepping_count + 1;
+    uc->uc_mcontext.gregs[REG_EFL] |= trap_flag;
+}
+
+void on_step( int, siginfo_t *, void * context) {
+    for ( std::size_t i = 0; i < stepping_count; ++i) {
+        // the stack might have been deallocated by the instruction
+        if ( armed && nullptr != find( stepping[i]) ) {
+            protect( stepping[i], page_size(), true);
+        }
+    }
+    stepping_count = 0;
+    static_cast< ucontext_t * >( context)->uc_mcontext.gregs[REG_EFL] &= ~trap_flag;
+}
+
+// the handlers run on an alternate stack: the faulting stack is protected
+void install_handlers() {
+    static bool installed = false;
+    if ( installed) {
+        return;
+    }
+    // not initialized inside the handlers
+    page_size();
+    line_size();
+    static std::vector< char > altstack( 64 * 1024);
+    stack_t ss;
+    ss.ss_sp = altstack.data();
+    ss.ss_size = altstack.size();
+    ss.ss_flags = 0;
+    if ( 0 != ::sigaltstack( & ss, nullptr) ) {
+        throw std::runtime_error("sigaltstack() failed");
+    }
+    struct sigaction sa;
+    ::sigemptyset( & sa.sa_mask);
+    sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sa.sa_sigaction = on_fault;
+    ::sigaction( SIGSEGV, & sa, nullptr);
+    sa.sa_sigaction = on_step;
+    ::sigaction( SIGTRAP, & sa, nullptr);
+    installed = true;
+}
+#endif
+
+// lines and pages of the accesses [first, last)
+struct footprint {
+    std::size_t                                                     accesses{ 0 };
+    std::size_t                                                     lines{ 0 };
+    std::size_t                                                     written{ 0 };
+    std::size_t                                                     pages{ 0 };
+    // per kind of stack: offset of the line to the top -> written
+    std::map< std::string, std::map< std::size_t, bool > >         offsets{};
+};
+
+footprint analyze( std::size_t first, std::size_t last) {
+    std::map< boost::uintptr_t, bool > lines;
+    std::set< boost::uintptr_t > pages;
+    footprint f;
+    f.accesses = last - first;
+    for ( std::size_t i = first; i < last; ++i) {
+        touch const& a = accesses[i];
+        bool & written = lines[a.addr & ~( line_size() - 1)];
+        written = written || a.write;
+        pages.insert( a.addr & ~( page_size() - 1) );
+        bool & w = f.offsets[a.kind][a.offset];
+        w = w || a.write;
+    }
+    f.lines = lines.size();
+    for ( auto const& l : lines) {
+        if ( l.second) {
+            ++f.written;
+        }
+    }
+    f.pages = pages.size();
+    return f;
+}
+
+}
+
+ctx::stack_context
+traced_stack::allocate() {
+#if defined(BOOST_CONTEXT_FOOTPRINT)
+    void * vp = ::mmap( nullptr, stack_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ( MAP_FAILED == vp) {
+        throw std::bad_alloc();
+    }
+    std::size_t i = 0;
+    while ( i < region_count && regions[i].active) {
+        ++i;
+    }
+    if ( max_regions == i) {
+        ::munmap( vp, stack_size);
+        throw std::bad_alloc();
+    }
+    regions[i].base = reinterpret_cast< boost::uintptr_t >( vp);
+    regions[i].size = stack_size;
+    regions[i].kind = kind_;
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+    regions[i].active = 1;
+    if ( region_count == i) {
+        region_count = i + 1;
+    }
+    if ( armed) {
+        protect( regions[i].base, stack_size, true);
+    }
+    ctx::stack_context sctx;
+    sctx.size = stack_size;
+    sctx.sp = static_cast< char * >( vp) + stack_size;
+    return sctx;
+#else
+    throw std::logic_error("tracing not supported");
+#endif
+}
+
+void
+traced_stack::deallocate( ctx::stack_context & sctx) noexcept {
+#if defined(BOOST_CONTEXT_FOOTPRINT)
+    void * vp = static_cast< char * >( sctx.sp) - sctx.size;
+    for ( std::size_t i = 0; i < region_count; ++i) {
+        if ( regions[i].active && reinterpret_cast< boost::uintptr_t >( vp) == regions[i].base) {
+            regions[i].active = 0;
+        }
+    }
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+    ::munmap( vp, sctx.size);
+#else
+    ( void)sctx;
+#endif
+}
+
+void arm() {
+#if defined(BOOST_CONTEXT_FOOTPRINT)
+    armed = 1;
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+    for ( std::size_t i = 0; i < region_count; ++i) {
+        if ( regions[i].active) {
+            protect( regions[i].base, regions[i].size, true);
+        }
+    }
+#endif
+}
+
+void disarm() {
+#if defined(BOOST_CONTEXT_FOOTPRINT)
+    armed = 0;
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+    for ( std::size_t i = 0; i < region_count; ++i) {
+        if ( regions[i].active) {
+            protect( regions[i].base, regions[i].size, false);
+        }
+    }
+#endif
+}
+
+namespace {
+
+struct driver_data {
+    std::function< void() > const*  fn;
+    std::exception_ptr              ex;
+};
+
+void driver_entry( ctx::detail::transfer_t t) {
+    driver_data * d = static_cast< driver_data * >( t.data);
+    try {
+        ( * d->fn)();
+    } catch (...) {
+        d->ex = std::current_exception();
+    }
+    ctx::detail::jump_fcontext( t.fctx, nullptr);
+}
+
+}
+
+void run_traced( std::function< void() > const& fn) {
+#if defined(BOOST_CONTEXT_FOOTPRINT)
+    install_handlers();
+#endif
+    traced_stack salloc( "driver");
+    ctx::stack_context sctx = salloc.allocate();
+    driver_data d{ & fn, nullptr };
+    ctx::detail::jump_fcontext(
+            ctx::detail::make_fcontext( sctx.sp, sctx.size, driver_entry),
+            & d);
+    salloc.deallocate( sctx);
+    if ( d.ex) {
+        std::rethrow_exception( d.ex);
+    }
+}
+
+void sample( json_report & report, std::string const& api, std::vector< std::string > const& segments,
+             std::function< void() > const& fn, std::string const& total) {
+    if ( ! filter.empty() && std::string::npos == api.find( filter) ) {
+        return;
+    }
+    std::vector< std::string > names( segments);
+    if ( 1 < segments.size() ) {
+        names.push_back( total);
+    }
+    std::vector< std::vector< double > > lines( names.size() );
+    std::vector< footprint > last( names.size() );
+    for ( boost::uint64_t r = 0; r < repetitions; ++r) {
+        fn();
+        if ( overflow) {
+            throw std::runtime_error("too many accesses traced");
+        }
+        if ( segments.size() != mark_count + 1) {
+            throw std::logic_error("unexpected number of trace segments of " + api);
+        }
+        for ( std::size_t i = 0; i < names.size(); ++i) {
+            // the whole trace comes last
+            const std::size_t first = i < segments.size() && 0 < i ? marks[i - 1] : 0;
+            const std::size_t end = i + 1 < segments.size() ? marks[i] : access_count;
+            last[i] = analyze( first, end);
+            lines[i].push_back( static_cast< double >( last[i].lines) );
+        }
+    }
+    for ( std::size_t i = 0; i < names.size(); ++i) {
+        footprint const& f = last[i];
+        json_report::extra_type extra;
+        extra.emplace_back( "written", static_cast< double >( f.written) );
+        extra.emplace_back( "pages", static_cast< double >( f.pages) );
+        extra.emplace_back( "accesses", static_cast< double >( f.accesses) );
+        for ( auto const& k : f.offsets) {
+            extra.emplace_back( "lines_" + k.first, static_cast< double >( k.second.size() ) );
+        }
+        statistics const& s = report.add( "footprint/" + api + "/" + names[i], "cache lines", lines[i], extra);
+        table() << std::left << std::setw( 10) << api << std::setw( 20) << names[i] << std::right
+                << " lines " << std::setw( 4) << s.median
+                << " (written " << std::setw( 3) << f.written << ")"
+                << " pages " << std::setw( 3) << f.pages
+                << " accesses " << std::setw( 5) << f.accesses;
+        for ( auto const& k : f.offsets) {
+            table() << "  " << k.first << " " << k.second.size();
+        }
+        if ( s.min != s.max) {
+            table() << "  (min " << s.min << ", max " << s.max << ")";
+        }
+        table() << std::endl;
+        if ( verbose) {
+            // offsets of the lines to the top of their stack; w: written
+            for ( auto const& k : f.offsets) {
+                table() << std::setw( 12) << "" << k.first << ":";
+                for ( auto const& l : k.second) {
+                    table() << " -" << l.first << ( l.second ? "w" : "");
+                }
+                table() << std::endl;
+            }
+        }
+    }
+}
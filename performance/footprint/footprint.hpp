@@ -0,0 +1,119 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FOOTPRINT_H
+#define FOOTPRINT_H
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/context/stack_context.hpp>
+#include <boost/cstdint.hpp>
+
+#include "../stats.hpp"
+
+// accesses to the traced stacks are recorded between trace_begin() and
+// trace_end(): the stacks are protected, each access faults, the faulting
+// address is recorded and the instruction is single-stepped with the page
+// accessible (x86/x86_64 Linux only)
+#if defined(__linux__) && ( defined(__x86_64__) || defined(__i386__) )
+# define BOOST_CONTEXT_FOOTPRINT
+#endif
+
+// samples taken per operation
+extern boost::uint64_t repetitions;
+// only APIs whose name contains `filter` are traced
+extern std::string filter;
+// list the touched lines
+extern bool verbose;
+// '-' if the JSON report goes to stdout
+extern std::string json_file;
+
+const std::size_t stack_size = 64 * 1024;
+
+inline
+std::ostream & table() {
+    return "-" == json_file ? std::cerr : std::cout;
+}
+
+// set by trace_begin(), checked by the signal handler
+extern volatile std::sig_atomic_t recording;
+extern volatile std::size_t access_count;
+const std::size_t max_marks = 8;
+extern volatile std::size_t marks[max_marks];
+extern volatile std::size_t mark_count;
+
+// protect/unprotect the traced stacks
+void arm();
+void disarm();
+
+// the flags are set inline: the calls to arm() and disarm() are not recorded
+inline
+void trace_begin() {
+    arm();
+    mark_count = 0;
+    access_count = 0;
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+    recording = 1;
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+}
+
+inline
+void trace_end() {
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+    recording = 0;
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+    disarm();
+}
+
+// splits the trace into segments, e.g. the two switches of a round trip
+inline
+void trace_mark() {
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+    if ( recording && max_marks > mark_count) {
+        marks[mark_count] = access_count;
+        mark_count = mark_count + 1;
+    }
+    std::atomic_signal_fence( std::memory_order_seq_cst);
+}
+
+// stacks allocated with mmap(); traced while they are alive
+class traced_stack {
+private:
+    char const*     kind_;
+
+public:
+    explicit traced_stack( char const* kind = "context") noexcept :
+        kind_( kind) {
+    }
+
+    boost::context::stack_context allocate();
+
+    void deallocate( boost::context::stack_context &) noexcept;
+};
+
+// runs `fn` on a traced stack (the driver); the stack of the caller is not
+// traced
+void run_traced( std::function< void() > const& fn);
+
+// calls `fn` (which traces the operation) `repetitions` times and reports
+// the distinct cache lines and pages touched per segment of the trace
+// (separated by trace_mark()); with more than one segment `total` names the
+// whole trace
+void sample( json_report & report, std::string const& api, std::vector< std::string > const& segments,
+             std::function< void() > const& fn, std::string const& total = std::string() );
+
+// one function per API, each in its own translation unit (as in
+// performance/suite)
+void measure_fcontext( json_report &);
+void measure_callcc( json_report &);
+void measure_execution_context( json_report &);
+
+#endif // FOOTPRINT_H
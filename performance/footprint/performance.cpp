@@ -0,0 +1,86 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// distinct cache lines and pages of the stacks touched by a switch and by
+// creating and destroying a context, for each API
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "footprint.hpp"
+
+boost::uint64_t repetitions = 10;
+std::string filter;
+bool verbose = false;
+std::string json_file;
+
+int main( int argc, char * argv[]) {
+    try {
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("repetitions,r", boost::program_options::value< boost::uint64_t >( & repetitions), "samples per operation")
+            ("filter,f", boost::program_options::value< std::string >( & filter), "trace APIs whose name contains the string")
+            ("verbose,v", boost::program_options::bool_switch( & verbose), "list the offsets of the touched lines to the top of their stack")
+            ("json,o", boost::program_options::value< std::string >( & json_file), "write results as JSON to file ('-' for stdout)");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if ( 0 == repetitions) {
+            throw std::invalid_argument("repetitions must not be zero");
+        }
+#if ! defined(BOOST_CONTEXT_FOOTPRINT)
+        std::cerr << "tracing requires x86 or x86_64 Linux" << std::endl;
+        return EXIT_FAILURE;
+#else
+        json_report report;
+        run_traced([&report](){
+                    // lines touched by tracing itself
+                    sample( report, "none", { "empty" },
+                            [](){
+                                trace_begin();
+                                trace_end();
+                            });
+                    measure_fcontext( report);
+                    measure_callcc( report);
+                    measure_execution_context( report);
+                });
+
+        if ( "-" == json_file) {
+            report.write( std::cout);
+        } else if ( ! json_file.empty() ) {
+            std::ofstream os( json_file.c_str() );
+            if ( ! os) {
+                throw std::runtime_error("can not open " + json_file);
+            }
+            report.write( os);
+        }
+
+        return EXIT_SUCCESS;
+#endif
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,342 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef IO_URING_H
+#define IO_URING_H
+
+extern "C" {
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <system_error>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/context/continuation.hpp>
+
+// minimal io_uring binding on top of the raw system calls (no liburing required)
+class uring {
+private:
+    int                 fd_{ -1 };
+    io_uring_params     params_;
+    void            *   sq_ptr_{ MAP_FAILED };
+    std::size_t         sq_len_{ 0 };
+    void            *   cq_ptr_{ MAP_FAILED };
+    std::size_t         cq_len_{ 0 };
+    io_uring_sqe    *   sqes_{ static_cast< io_uring_sqe * >( MAP_FAILED) };
+    std::size_t         sqes_len_{ 0 };
+    unsigned        *   sq_head_{ nullptr };
+    unsigned        *   sq_tail_{ nullptr };
+    unsigned        *   sq_mask_{ nullptr };
+    unsigned        *   sq_array_{ nullptr };
+    unsigned        *   cq_head_{ nullptr };
+    unsigned        *   cq_tail_{ nullptr };
+    unsigned        *   cq_mask_{ nullptr };
+    io_uring_cqe    *   cqes_{ nullptr };
+    // SQEs filled by get_sqe() but not yet published to the kernel
+    unsigned            sq_local_tail_{ 0 };
+    unsigned            sq_published_{ 0 };
+
+    void close_() noexcept {
+        if ( MAP_FAILED != static_cast< void * >( sqes_) ) {
+            ::munmap( sqes_, sqes_len_);
+        }
+        if ( MAP_FAILED != cq_ptr_ && cq_ptr_ != sq_ptr_) {
+            ::munmap( cq_ptr_, cq_len_);
+        }
+        if ( MAP_FAILED != sq_ptr_) {
+            ::munmap( sq_ptr_, sq_len_);
+        }
+        if ( -1 != fd_) {
+            ::close( fd_);
+        }
+    }
+
+    [[noreturn]]
+    void fail_( char const* what) {
+        const int err = errno;
+        close_();
+        throw std::system_error( err, std::system_category(), what);
+    }
+
+public:
+    explicit uring( unsigned entries) {
+        std::memset( & params_, 0, sizeof( params_) );
+        fd_ = static_cast< int >( ::syscall( __NR_io_uring_setup, entries, & params_) );
+        if ( 0 > fd_) {
+            fail_("io_uring_setup() failed");
+        }
+        sq_len_ = params_.sq_off.array + params_.sq_entries * sizeof( unsigned);
+        cq_len_ = params_.cq_off.cqes + params_.cq_entries * sizeof( io_uring_cqe);
+        const bool single_mmap = 0 != ( params_.features & IORING_FEAT_SINGLE_MMAP);
+        if ( single_mmap) {
+            sq_len_ = cq_len_ = ( std::max)( sq_len_, cq_len_);
+        }
+        sq_ptr_ = ::mmap( nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          fd_, IORING_OFF_SQ_RING);
+        if ( MAP_FAILED == sq_ptr_) {
+            fail_("mmap() of submission queue failed");
+        }
+        if ( single_mmap) {
+            cq_ptr_ = sq_ptr_;
+        } else {
+            cq_ptr_ = ::mmap( nullptr, cq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              fd_, IORING_OFF_CQ_RING);
+            if ( MAP_FAILED == cq_ptr_) {
+                fail_("mmap() of completion queue failed");
+            }
+        }
+        sqes_len_ = params_.sq_entries * sizeof( io_uring_sqe);
+        sqes_ = static_cast< io_uring_sqe * >(
+                ::mmap( nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd_, IORING_OFF_SQES) );
+        if ( MAP_FAILED == static_cast< void * >( sqes_) ) {
+            fail_("mmap() of submission queue entries failed");
+        }
+        char * sq = static_cast< char * >( sq_ptr_);
+        sq_head_ = reinterpret_cast< unsigned * >( sq + params_.sq_off.head);
+        sq_tail_ = reinterpret_cast< unsigned * >( sq + params_.sq_off.tail);
+        sq_mask_ = reinterpret_cast< unsigned * >( sq + params_.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast< unsigned * >( sq + params_.sq_off.array);
+        char * cq = static_cast< char * >( cq_ptr_);
+        cq_head_ = reinterpret_cast< unsigned * >( cq + params_.cq_off.head);
+        cq_tail_ = reinterpret_cast< unsigned * >( cq + params_.cq_off.tail);
+        cq_mask_ = reinterpret_cast< unsigned * >( cq + params_.cq_off.ring_mask);
+        cqes_ = reinterpret_cast< io_uring_cqe * >( cq + params_.cq_off.cqes);
+        sq_local_tail_ = sq_published_ = * sq_tail_;
+    }
+
+    ~uring() {
+        close_();
+    }
+
+    uring( uring const&) = delete;
+    uring & operator=( uring const&) = delete;
+
+    // returns a zeroed submission queue entry or nullptr if the queue is full
+    io_uring_sqe * get_sqe() noexcept {
+        const unsigned head = __atomic_load_n( sq_head_, __ATOMIC_ACQUIRE);
+        if ( sq_local_tail_ - head >= params_.sq_entries) {
+            return nullptr;
+        }
+        const unsigned idx = sq_local_tail_ & * sq_mask_;
+        io_uring_sqe * sqe = & sqes_[idx];
+        std::memset( sqe, 0, sizeof( io_uring_sqe) );
+        sq_array_[idx] = idx;
+        ++sq_local_tail_;
+        return sqe;
+    }
+
+    unsigned pending() const noexcept {
+        return sq_local_tail_ - sq_published_;
+    }
+
+    // publishes all queued entries with one io_uring_enter() and
+    // optionally blocks until `wait_nr` completions are available; returns
+    // the number of entries consumed by the kernel. Entries the kernel did
+    // not consume stay pending and are submitted again.
+    int submit_and_wait( unsigned wait_nr) {
+        __atomic_store_n( sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+        int submitted = 0;
+        for (;;) {
+            const unsigned to_submit = sq_local_tail_ - sq_published_;
+            if ( 0 == to_submit && 0 == wait_nr) {
+                return submitted;
+            }
+            const int result = static_cast< int >( ::syscall( __NR_io_uring_enter, fd_, to_submit, wait_nr,
+                                                              0 < wait_nr ? IORING_ENTER_GETEVENTS : 0,
+                                                              nullptr, 0) );
+            if ( 0 > result) {
+                if ( EINTR == errno) {
+                    continue;
+                }
+                if ( EAGAIN == errno || EBUSY == errno) {
+                    // out of resources or completion queue full: the caller
+                    // reaps completions first, the entries stay pending
+                    return submitted;
+                }
+                throw std::system_error( errno, std::system_category(), "io_uring_enter() failed");
+            }
+            sq_published_ += static_cast< unsigned >( result);
+            submitted += result;
+            // the kernel stops at an entry it can not submit (its CQE
+            // carries the error); submit the remaining ones
+            if ( 0 == result || static_cast< unsigned >( result) >= to_submit) {
+                return submitted;
+            }
+        }
+    }
+
+    // reaps all available completions; returns the number of reaped entries
+    template< typename Fn >
+    unsigned for_each_cqe( Fn && fn) {
+        unsigned head = * cq_head_;
+        const unsigned tail = __atomic_load_n( cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned n = 0;
+        for ( ; head != tail; ++head, ++n) {
+            fn( cqes_[head & * cq_mask_]);
+        }
+        __atomic_store_n( cq_head_, head, __ATOMIC_RELEASE);
+        return n;
+    }
+};
+
+// drives continuations that suspend on io_uring operations
+//
+// A continuation spawned by io_service queues an SQE and suspends; all SQEs
+// queued while running the ready continuations of one loop iteration are
+// submitted with a single io_uring_enter(). The completion pump resumes each
+// continuation with the CQE result passed through continuation::resume().
+class io_service {
+private:
+    struct task {
+        boost::context::continuation    caller{};
+        boost::context::continuation    self{};
+    };
+
+    struct completion {
+        task    *   t;
+        int         result;
+    };
+
+    uring                       ring_;
+    std::deque< completion >    ready_{};
+    task                    *   current_{ nullptr };
+    task                    *   suspended_{ nullptr };
+    std::size_t                 active_{ 0 };
+
+    io_uring_sqe * prepare_( std::uint8_t opcode, int fd) {
+        BOOST_ASSERT_MSG( nullptr != current_, "io operations must be called from a spawned continuation");
+        io_uring_sqe * sqe = ring_.get_sqe();
+        if ( nullptr == sqe) {
+            // submission queue is full, hand over the batch without waiting
+            ring_.submit_and_wait( 0);
+            sqe = ring_.get_sqe();
+            BOOST_ASSERT( nullptr != sqe);
+        }
+        sqe->opcode = opcode;
+        sqe->fd = fd;
+        sqe->user_data = reinterpret_cast< std::uint64_t >( current_);
+        return sqe;
+    }
+
+    int suspend_() {
+        task * t = current_;
+        suspended_ = t;
+        // switch back to whoever resumed us; the completion pump passes the CQE result
+        t->caller = t->caller.resume();
+        current_ = t;
+        return t->caller.get_data< int >();
+    }
+
+    void resume_( task * t, int result) {
+        current_ = t;
+        boost::context::continuation c = t->self.resume( result);
+        current_ = nullptr;
+        if ( c) {
+            t->self = std::move( c);
+        } else {
+            --active_;
+        }
+    }
+
+public:
+    explicit io_service( unsigned entries = 256) :
+        ring_( entries) {
+    }
+
+    io_service( io_service const&) = delete;
+    io_service & operator=( io_service const&) = delete;
+
+    // runs `fn( io_service &)` inside a new continuation up to its first io operation
+    template< typename StackAlloc, typename Fn >
+    void spawn( std::allocator_arg_t, StackAlloc salloc, Fn && fn) {
+        task * parent = current_;
+        ++active_;
+        boost::context::continuation c = boost::context::callcc(
+            std::allocator_arg, salloc,
+            [this,fn]( boost::context::continuation && caller) mutable {
+                task t;
+                t.caller = std::move( caller);
+                current_ = & t;
+                fn( * this);
+                current_ = nullptr;
+                return std::move( t.caller);
+            });
+        current_ = parent;
+        if ( c) {
+            // the new continuation is suspended on its first operation
+            suspended_->self = std::move( c);
+        } else {
+            --active_;
+        }
+    }
+
+    template< typename Fn >
+    void spawn( Fn && fn) {
+        spawn( std::allocator_arg, boost::context::fixedsize_stack(), std::forward< Fn >( fn) );
+    }
+
+    // completion pump: resumes ready continuations, then submits the SQEs they
+    // queued as one batch and waits for the next completions
+    void run() {
+        while ( 0 < active_) {
+            while ( ! ready_.empty() ) {
+                completion c = ready_.front();
+                ready_.pop_front();
+                resume_( c.t, c.result);
+            }
+            if ( 0 == active_) {
+                break;
+            }
+            ring_.submit_and_wait( 1);
+            ring_.for_each_cqe( [this]( io_uring_cqe const& cqe) {
+                ready_.push_back( completion{ reinterpret_cast< task * >( cqe.user_data), cqe.res });
+            });
+        }
+    }
+
+    // asynchronous operations; must be called from a spawned continuation
+    // return the CQE result (number of bytes, file descriptor or -errno)
+    int read( int fd, void * buf, unsigned len, std::uint64_t off = 0) {
+        io_uring_sqe * sqe = prepare_( IORING_OP_READ, fd);
+        sqe->addr = reinterpret_cast< std::uint64_t >( buf);
+        sqe->len = len;
+        sqe->off = off;
+        return suspend_();
+    }
+
+    int write( int fd, void const* buf, unsigned len, std::uint64_t off = 0) {
+        io_uring_sqe * sqe = prepare_( IORING_OP_WRITE, fd);
+        sqe->addr = reinterpret_cast< std::uint64_t >( buf);
+        sqe->len = len;
+        sqe->off = off;
+        return suspend_();
+    }
+
+    int accept( int fd, sockaddr * addr = nullptr, socklen_t * addrlen = nullptr) {
+        io_uring_sqe * sqe = prepare_( IORING_OP_ACCEPT, fd);
+        sqe->addr = reinterpret_cast< std::uint64_t >( addr);
+        sqe->addr2 = reinterpret_cast< std::uint64_t >( addrlen);
+        return suspend_();
+    }
+
+    int fsync( int fd) {
+        prepare_( IORING_OP_FSYNC, fd);
+        return suspend_();
+    }
+};
+
+#endif // IO_URING_H
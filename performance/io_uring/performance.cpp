@@ -0,0 +1,247 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+extern "C" {
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+#include "io_uring.hpp"
+
+boost::uint64_t blocks = 16384;
+boost::uint64_t block_size = 4096;
+boost::uint64_t connections = 64;
+boost::uint64_t messages = 1000;
+boost::uint64_t concurrency = 32;
+
+static void check( bool ok, char const* what) {
+    if ( ! ok) {
+        throw std::system_error( errno, std::system_category(), what);
+    }
+}
+
+// file read
+
+static int make_file( std::string & path) {
+    char name[] = "/tmp/boost_context_io_uring_XXXXXX";
+    int fd = ::mkstemp( name);
+    check( -1 != fd, "mkstemp() failed");
+    path = name;
+    std::vector< char > buf( block_size, 'x');
+    for ( boost::uint64_t i = 0; i < blocks; ++i) {
+        check( static_cast< ssize_t >( block_size) == ::write( fd, buf.data(), buf.size() ), "write() failed");
+    }
+    check( 0 == ::fsync( fd), "fsync() failed");
+    return fd;
+}
+
+duration_type measure_file_blocking( int fd) {
+    std::vector< char > buf( block_size);
+    time_point_type start( clock_type::now() );
+    for ( boost::uint64_t i = 0; i < blocks; ++i) {
+        check( static_cast< ssize_t >( block_size) == ::pread( fd, buf.data(), buf.size(), i * block_size),
+               "pread() failed");
+    }
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= blocks;
+
+    return total;
+}
+
+duration_type measure_file_uring( int fd) {
+    io_service io( 256);
+    time_point_type start( clock_type::now() );
+    for ( boost::uint64_t n = 0; n < concurrency; ++n) {
+        io.spawn( [fd,n]( io_service & io) {
+            std::vector< char > buf( block_size);
+            for ( boost::uint64_t i = n; i < blocks; i += concurrency) {
+                int res = io.read( fd, buf.data(), static_cast< unsigned >( buf.size() ), i * block_size);
+                BOOST_ASSERT( static_cast< int >( block_size) == res);
+                ( void)res;
+            }
+        });
+    }
+    io.run();
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= blocks;
+
+    return total;
+}
+
+// loopback socket ping-pong
+
+static int make_listener( sockaddr_in & addr) {
+    int fd = ::socket( AF_INET, SOCK_STREAM, 0);
+    check( -1 != fd, "socket() failed");
+    std::memset( & addr, 0, sizeof( addr) );
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof( addr);
+    check( 0 == ::bind( fd, reinterpret_cast< sockaddr * >( & addr), len), "bind() failed");
+    check( 0 == ::listen( fd, static_cast< int >( connections) ), "listen() failed");
+    check( 0 == ::getsockname( fd, reinterpret_cast< sockaddr * >( & addr), & len), "getsockname() failed");
+    return fd;
+}
+
+static int make_client( sockaddr_in const& addr) {
+    int fd = ::socket( AF_INET, SOCK_STREAM, 0);
+    check( -1 != fd, "socket() failed");
+    int one = 1;
+    ::setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, & one, sizeof( one) );
+    check( 0 == ::connect( fd, reinterpret_cast< sockaddr const* >( & addr), sizeof( addr) ), "connect() failed");
+    return fd;
+}
+
+duration_type measure_socket_blocking() {
+    sockaddr_in addr;
+    int lfd = make_listener( addr);
+    std::vector< int > clients, servers;
+    for ( boost::uint64_t i = 0; i < connections; ++i) {
+        clients.push_back( make_client( addr) );
+        servers.push_back( ::accept( lfd, nullptr, nullptr) );
+        check( -1 != servers.back(), "accept() failed");
+    }
+    char buf[64] = { 0 };
+    time_point_type start( clock_type::now() );
+    for ( boost::uint64_t m = 0; m < messages; ++m) {
+        for ( boost::uint64_t i = 0; i < connections; ++i) {
+            check( sizeof( buf) == ::write( clients[i], buf, sizeof( buf) ), "write() failed");
+            check( sizeof( buf) == ::read( servers[i], buf, sizeof( buf) ), "read() failed");
+            check( sizeof( buf) == ::write( servers[i], buf, sizeof( buf) ), "write() failed");
+            check( sizeof( buf) == ::read( clients[i], buf, sizeof( buf) ), "read() failed");
+        }
+    }
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= messages * connections;  // round-trips
+    for ( boost::uint64_t i = 0; i < connections; ++i) {
+        ::close( clients[i]);
+        ::close( servers[i]);
+    }
+    ::close( lfd);
+
+    return total;
+}
+
+duration_type measure_socket_uring() {
+    sockaddr_in addr;
+    int lfd = make_listener( addr);
+    std::vector< int > clients;
+    for ( boost::uint64_t i = 0; i < connections; ++i) {
+        clients.push_back( make_client( addr) );
+    }
+    io_service io( 512);
+    time_point_type start( clock_type::now() );
+    // acceptor spawns one echo continuation per accepted connection
+    io.spawn( [lfd]( io_service & io) {
+        for ( boost::uint64_t i = 0; i < connections; ++i) {
+            int fd = io.accept( lfd);
+            BOOST_ASSERT( 0 <= fd);
+            io.spawn( [fd]( io_service & io) {
+                char buf[64];
+                for ( boost::uint64_t m = 0; m < messages; ++m) {
+                    int n = io.read( fd, buf, sizeof( buf) );
+                    if ( 0 >= n) break;
+                    io.write( fd, buf, static_cast< unsigned >( n) );
+                }
+                ::close( fd);
+            });
+        }
+    });
+    for ( boost::uint64_t i = 0; i < connections; ++i) {
+        int fd = clients[i];
+        io.spawn( [fd]( io_service & io) {
+            char buf[64] = { 0 };
+            for ( boost::uint64_t m = 0; m < messages; ++m) {
+                io.write( fd, buf, sizeof( buf) );
+                int n = io.read( fd, buf, sizeof( buf) );
+                BOOST_ASSERT( sizeof( buf) == n);
+                ( void)n;
+            }
+        });
+    }
+    io.run();
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= messages * connections;  // round-trips
+    for ( int fd : clients) {
+        ::close( fd);
+    }
+    ::close( lfd);
+
+    return total;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("blocks,b", boost::program_options::value< boost::uint64_t >( & blocks), "blocks read from file")
+            ("block-size,s", boost::program_options::value< boost::uint64_t >( & block_size), "size of a block")
+            ("concurrency,c", boost::program_options::value< boost::uint64_t >( & concurrency), "continuations reading the file")
+            ("connections,n", boost::program_options::value< boost::uint64_t >( & connections), "loopback connections")
+            ("messages,m", boost::program_options::value< boost::uint64_t >( & messages), "round-trips per connection");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        std::string path;
+        int fd = make_file( path);
+        boost::uint64_t res = measure_file_blocking( fd).count();
+        std::cout << "file read, blocking pread(): average of " << res << " nano seconds" << std::endl;
+        res = measure_file_uring( fd).count();
+        std::cout << "file read, io_uring + continuation: average of " << res << " nano seconds" << std::endl;
+        ::close( fd);
+        ::unlink( path.c_str() );
+
+        res = measure_socket_blocking().count();
+        std::cout << "loopback round-trip, blocking read()/write(): average of " << res << " nano seconds" << std::endl;
+        res = measure_socket_uring().count();
+        std::cout << "loopback round-trip, io_uring + continuation: average of " << res << " nano seconds" << std::endl;
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,215 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/context/segmented_stack.hpp>
+#include <boost/context/slab_protected_stack.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+#include "../stats.hpp"
+
+namespace ctx = boost::context;
+
+boost::uint64_t batch = 1000;
+boost::uint64_t repetitions = 100;
+boost::uint64_t warmup = 5;
+boost::uint64_t max_threads = ( std::max)( std::thread::hardware_concurrency(), 1u);
+boost::uint64_t stack_kb = 64;
+std::string allocator_name;
+std::string json_file;
+
+// phases of the life of a continuation, measured separately
+enum phase {
+    // allocate the stack and prepare the context (context_prepare), no switch
+    create = 0,
+    // first resume: the first jump into the context, `body` is entered and
+    // suspends
+    first_switch,
+    // resume until the function returns (context_exit, stack deallocated)
+    finish,
+    // destroy a suspended continuation (context_unwind, stack deallocated)
+    destroy,
+    phases
+};
+
+char const* phase_name( int p) {
+    static char const* names[] = { "create", "first-switch", "finish", "destroy-suspended" };
+    return names[p];
+}
+
+static ctx::continuation body( ctx::continuation && c) {
+    c = c.resume();
+    return std::move( c);
+}
+
+std::ostream & table() {
+    return "-" == json_file ? std::cerr : std::cout;
+}
+
+// per repetition `batch` continuations are created and resumed once; half of
+// them is resumed again and finishes, the other half is destroyed while
+// suspended; each sample is the time per operation in ns
+template< typename StackAllocator >
+void run( StackAllocator salloc, std::vector< std::vector< double > > & samples) {
+    std::vector< ctx::continuation > cs;
+    cs.reserve( batch);
+    const std::size_t half = batch / 2;
+    for ( boost::uint64_t r = 0; r < warmup + repetitions; ++r) {
+        time_point_type t0( clock_type::now() );
+        for ( boost::uint64_t i = 0; i < batch; ++i) {
+            cs.push_back( ctx::make_continuation( std::allocator_arg, salloc, body) );
+        }
+        time_point_type t1( clock_type::now() );
+        for ( ctx::continuation & c : cs) {
+            c = c.resume();
+        }
+        time_point_type t2( clock_type::now() );
+        for ( std::size_t i = 0; i < half; ++i) {
+            cs[i] = cs[i].resume();
+        }
+        time_point_type t3( clock_type::now() );
+        cs.clear();
+        time_point_type t4( clock_type::now() );
+        if ( warmup <= r) {
+            samples[create].push_back( static_cast< double >( ( t1 - t0).count() ) / batch);
+            samples[first_switch].push_back( static_cast< double >( ( t2 - t1).count() ) / batch);
+            samples[finish].push_back( static_cast< double >( ( t3 - t2).count() ) / ( std::max)( half, std::size_t( 1) ) );
+            samples[destroy].push_back( static_cast< double >( ( t4 - t3).count() ) / ( std::max)( batch - half, boost::uint64_t( 1) ) );
+        }
+    }
+}
+
+// `threads` threads run concurrently, each with its own allocator created
+// by `make` (as a scheduler would do; copies of pooled_fixedsize_stack share
+// the pool, which is not thread-safe)
+template< typename Factory >
+void measure( json_report & report, std::string const& name, Factory make) {
+    if ( ! allocator_name.empty() && allocator_name != name) {
+        return;
+    }
+    const unsigned int processors = ( std::max)( std::thread::hardware_concurrency(), 1u);
+    for ( boost::uint64_t threads = 1; threads <= max_threads; ++threads) {
+        std::vector< std::vector< std::vector< double > > > samples(
+                threads, std::vector< std::vector< double > >( phases) );
+        std::atomic< boost::uint64_t > ready{ 0 };
+        std::vector< std::thread > ts;
+        for ( boost::uint64_t i = 0; i < threads; ++i) {
+            ts.emplace_back([&samples,&ready,&make,i,threads,processors](){
+                        bind_to_processor( static_cast< unsigned int >( i % processors) );
+                        auto salloc = make();
+                        // start at the same time
+                        ++ready;
+                        while ( ready < threads) {
+                            std::this_thread::yield();
+                        }
+                        run( salloc, samples[i]);
+                    });
+        }
+        for ( std::thread & t : ts) {
+            t.join();
+        }
+        for ( int p = create; p < phases; ++p) {
+            std::vector< double > all;
+            for ( boost::uint64_t i = 0; i < threads; ++i) {
+                all.insert( all.end(), samples[i][p].begin(), samples[i][p].end() );
+            }
+            const statistics s = summarize( all);
+            // operations per second of all threads together
+            const double throughput = 0 < s.mean ? threads * 1e9 / s.mean : 0;
+            std::ostringstream entry;
+            entry << "lifecycle/" << name << "/" << threads << "t/" << phase_name( p);
+            json_report::extra_type extra;
+            extra.emplace_back( "threads", static_cast< double >( threads) );
+            extra.emplace_back( "throughput", throughput);
+            report.add( entry.str(), "ns", all, extra);
+            table() << std::setw( 26) << std::left << name << std::right
+                    << std::setw( 4) << threads << " threads  "
+                    << std::setw( 18) << std::left << phase_name( p) << std::right
+                    << std::fixed << std::setprecision( 1)
+                    << " median " << std::setw( 9) << s.median << " ns"
+                    << "  p99 " << std::setw( 9) << s.p99 << " ns"
+                    << std::setprecision( 0)
+                    << std::setw( 12) << throughput << " ops/s" << std::endl;
+        }
+    }
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("batch,b", boost::program_options::value< boost::uint64_t >( & batch), "continuations per sample")
+            ("repetitions,r", boost::program_options::value< boost::uint64_t >( & repetitions), "samples per thread")
+            ("warmup,w", boost::program_options::value< boost::uint64_t >( & warmup), "samples discarded before measuring")
+            ("threads,t", boost::program_options::value< boost::uint64_t >( & max_threads), "measure with 1 .. threads threads")
+            ("stack,s", boost::program_options::value< boost::uint64_t >( & stack_kb), "stack size in KiB")
+            ("allocator,a", boost::program_options::value< std::string >( & allocator_name), "measure only this allocator")
+            ("json,o", boost::program_options::value< std::string >( & json_file), "write results as JSON to file ('-' for stdout)");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if ( 0 == batch || 0 == repetitions || 0 == max_threads) {
+            throw std::invalid_argument("batch, repetitions and threads must not be zero");
+        }
+
+        const std::size_t stack_size = stack_kb * 1024;
+        json_report report;
+        measure( report, "fixedsize_stack", [stack_size](){ return ctx::fixedsize_stack( stack_size); });
+        measure( report, "protected_fixedsize_stack", [stack_size](){ return ctx::protected_fixedsize_stack( stack_size); });
+        measure( report, "pooled_fixedsize_stack", [stack_size](){ return ctx::pooled_fixedsize_stack( stack_size); });
+        measure( report, "slab_protected_stack", [stack_size](){ return ctx::slab_protected_stack( stack_size); });
+#if defined(BOOST_USE_SEGMENTED_STACKS)
+        measure( report, "segmented_stack", [stack_size](){ return ctx::segmented_stack( stack_size); });
+#endif
+
+        if ( "-" == json_file) {
+            report.write( std::cout);
+        } else if ( ! json_file.empty() ) {
+            std::ofstream os( json_file.c_str() );
+            if ( ! os) {
+                throw std::runtime_error("can not open " + json_file);
+            }
+            report.write( os);
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
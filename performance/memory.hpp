@@ -0,0 +1,151 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <boost/config.hpp>
+#include <boost/context/stack_traits.hpp>
+
+#if ! defined(BOOST_WINDOWS)
+extern "C" {
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+}
+#endif
+
+#if defined(__GLIBC__)
+# include <malloc.h>
+#endif
+
+// resident set size of the process in bytes, 0 if unknown (read from
+// /proc/self/statm, Linux)
+inline
+std::size_t resident_size() {
+    std::ifstream is("/proc/self/statm");
+    std::size_t size = 0, resident = 0;
+    is >> size >> resident;
+    return resident * boost::context::stack_traits::page_size();
+}
+
+// RSS at which a benchmark stops creating; `limit_mb` if not zero, otherwise
+// `rss` plus half of the free physical memory (memory kept by the heap is
+// part of the RSS); 0 if unknown
+inline
+std::size_t rss_limit( std::size_t rss, std::size_t limit_mb) {
+    if ( 0 != limit_mb) {
+        return limit_mb * 1024 * 1024;
+    }
+#if defined(BOOST_WINDOWS)
+    ( void)rss;
+    return 0;
+#else
+    const long pages = ::sysconf( _SC_AVPHYS_PAGES);
+    return 0 < pages
+        ? rss + static_cast< std::size_t >( pages) / 2 * boost::context::stack_traits::page_size()
+        : 0;
+#endif
+}
+
+// what a function run by in_child_process() wrote and how the child ended
+struct child_result {
+    std::string     output;
+    // the function returned and its output was passed on completely
+    bool            success{ false };
+    // signal that terminated the child (e.g. the OOM killer), 0 if none
+    int             signal{ 0 };
+};
+
+// runs `fn` in a child process and returns what it wrote to the stream:
+// memory freed by previous measurements and kept by the heap or a pool is
+// not reused by `fn`. On Windows `fn` runs in this process
+inline
+child_result in_child_process( std::function< void( std::ostream &) > const& fn) {
+    child_result result;
+#if defined(BOOST_WINDOWS)
+    std::ostringstream os;
+    fn( os);
+    result.output = os.str();
+    result.success = true;
+#else
+    int fds[2];
+    if ( 0 != ::pipe( fds) ) {
+        throw std::runtime_error("pipe() failed");
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    const pid_t pid = ::fork();
+    if ( -1 == pid) {
+        ::close( fds[0]);
+        ::close( fds[1]);
+        throw std::runtime_error("fork() failed");
+    }
+    if ( 0 == pid) {
+        ::close( fds[0]);
+        int status = EXIT_SUCCESS;
+        try {
+# if defined(__GLIBC__)
+            // free memory inherited from the parent
+            ::malloc_trim( 0);
+# endif
+            std::ostringstream os;
+            fn( os);
+            const std::string str = os.str();
+            std::size_t written = 0;
+            while ( written < str.size() ) {
+                const ssize_t r = ::write( fds[1], str.data() + written, str.size() - written);
+                if ( 0 > r && EINTR == errno) {
+                    continue;
+                }
+                if ( 0 >= r) {
+                    status = EXIT_FAILURE;
+                    break;
+                }
+                written += static_cast< std::size_t >( r);
+            }
+        } catch ( std::exception const& e) {
+            std::cerr << "exception: " << e.what() << std::endl;
+            status = EXIT_FAILURE;
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        ::_exit( status);
+    }
+    ::close( fds[1]);
+    char buffer[4096];
+    for (;;) {
+        const ssize_t r = ::read( fds[0], buffer, sizeof( buffer) );
+        if ( 0 > r && EINTR == errno) {
+            continue;
+        }
+        if ( 0 >= r) {
+            break;
+        }
+        result.output.append( buffer, static_cast< std::size_t >( r) );
+    }
+    ::close( fds[0]);
+    int status = 0;
+    while ( -1 == ::waitpid( pid, & status, 0) && EINTR == errno) {
+    }
+    result.success = WIFEXITED( status) && EXIT_SUCCESS == WEXITSTATUS( status);
+    if ( WIFSIGNALED( status) ) {
+        result.signal = WTERMSIG( status);
+    }
+#endif
+    return result;
+}
+
+#endif // MEMORY_H
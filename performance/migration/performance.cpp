@@ -0,0 +1,343 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/handoff.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+#include "../stats.hpp"
+
+namespace ctx = boost::context;
+
+boost::uint64_t rounds = 10000;
+boost::uint64_t repetitions = 20;
+boost::uint64_t warmup = 2;
+std::size_t working_set = 0;
+std::string cpu_list;
+std::string json_file;
+
+// relation of two processors
+enum relation {
+    same_cpu = 0,
+    smt_sibling,
+    same_package,
+    other_package,
+    unknown
+};
+
+char const* relation_name( relation r) {
+    switch ( r) {
+    case same_cpu:
+        return "same cpu";
+    case smt_sibling:
+        return "smt sibling";
+    case same_package:
+        return "same package";
+    case other_package:
+        return "other package";
+    default:
+        return "unknown";
+    }
+}
+
+// physical package and core of a processor, -1 if unknown
+struct topology {
+    long    package{ -1 };
+    long    core{ -1 };
+};
+
+long read_topology( unsigned int cpu, char const* name) {
+#if defined(__linux__)
+    std::ostringstream path;
+    path << "/sys/devices/system/cpu/cpu" << cpu << "/topology/" << name;
+    std::ifstream is( path.str().c_str() );
+    long value = -1;
+    if ( is >> value) {
+        return value;
+    }
+#else
+    ( void)cpu;
+    ( void)name;
+#endif
+    return -1;
+}
+
+topology get_topology( unsigned int cpu) {
+    topology t;
+    t.package = read_topology( cpu, "physical_package_id");
+    t.core = read_topology( cpu, "core_id");
+    return t;
+}
+
+relation get_relation( unsigned int a, topology const& ta, unsigned int b, topology const& tb) {
+    if ( a == b) {
+        return same_cpu;
+    }
+    if ( -1 == ta.package || -1 == tb.package) {
+        return unknown;
+    }
+    if ( ta.package != tb.package) {
+        return other_package;
+    }
+    return -1 != ta.core && ta.core == tb.core ? smt_sibling : same_package;
+}
+
+// busy-waits for the continuation; gives up the processor from time to time
+// so that both threads make progress if they share a processor
+ctx::continuation spin_take( ctx::handoff & h) {
+    for ( unsigned int i = 1;; ++i) {
+        ctx::continuation c = h.try_take();
+        if ( c) {
+            return c;
+        }
+        if ( 0 == ( i % 4096) ) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// on each resume the continuation writes one byte per cache line of its
+// working set, which has to be transferred to the resuming processor
+ctx::continuation make_continuation() {
+    return ctx::callcc(
+            []( ctx::continuation && c) {
+                std::vector< char > data( working_set);
+                for (;;) {
+                    for ( std::size_t i = 0; i < data.size(); i += 64) {
+                        ++data[i];
+                    }
+                    c = c.resume();
+                }
+                return std::move( c);
+            });
+}
+
+// one-way hops between processors `a` and `b`: the thread on `a` resumes the
+// continuation and hands it to the thread on `b`, which resumes it and hands
+// it back; each sample is the mean of 2 * `rounds` hops
+std::vector< double > measure_pair( unsigned int a, unsigned int b) {
+    ctx::handoff to_a, to_b;
+    const boost::uint64_t total = ( warmup + repetitions) * rounds;
+    std::vector< double > samples;
+    samples.reserve( repetitions);
+    to_a.put( make_continuation() );
+    std::thread tb([&to_a,&to_b,b,total](){
+                bind_to_processor( b);
+                for ( boost::uint64_t i = 0; i < total; ++i) {
+                    ctx::continuation c = spin_take( to_b);
+                    c = c.resume();
+                    to_a.put( std::move( c) );
+                }
+            });
+    std::thread ta([&to_a,&to_b,&samples,a](){
+                bind_to_processor( a);
+                for ( boost::uint64_t r = 0; r < warmup + repetitions; ++r) {
+                    time_point_type start( clock_type::now() );
+                    for ( boost::uint64_t i = 0; i < rounds; ++i) {
+                        ctx::continuation c = spin_take( to_a);
+                        c = c.resume();
+                        to_b.put( std::move( c) );
+                    }
+                    // wait until the last hop has completed
+                    for ( unsigned int i = 1; to_a.empty(); ++i) {
+                        if ( 0 == ( i % 4096) ) {
+                            std::this_thread::yield();
+                        }
+                    }
+                    duration_type elapsed = clock_type::now() - start;
+                    if ( warmup <= r) {
+                        samples.push_back(
+                            static_cast< double >( elapsed.count() ) / ( 2 * rounds) );
+                    }
+                }
+            });
+    ta.join();
+    tb.join();
+    // the continuation left in `to_a` is unwound by the destructor
+    return samples;
+}
+
+// baseline: a single thread takes, resumes and puts back the continuation,
+// i.e. a hop without migration
+std::vector< double > measure_baseline( unsigned int a) {
+    ctx::handoff h;
+    std::vector< double > samples;
+    samples.reserve( repetitions);
+    h.put( make_continuation() );
+    std::thread t([&h,&samples,a](){
+                bind_to_processor( a);
+                for ( boost::uint64_t r = 0; r < warmup + repetitions; ++r) {
+                    time_point_type start( clock_type::now() );
+                    for ( boost::uint64_t i = 0; i < 2 * rounds; ++i) {
+                        ctx::continuation c = spin_take( h);
+                        c = c.resume();
+                        h.put( std::move( c) );
+                    }
+                    duration_type elapsed = clock_type::now() - start;
+                    if ( warmup <= r) {
+                        samples.push_back(
+                            static_cast< double >( elapsed.count() ) / ( 2 * rounds) );
+                    }
+                }
+            });
+    t.join();
+    return samples;
+}
+
+std::vector< unsigned int > parse_cpus( std::string const& str) {
+    std::vector< unsigned int > cpus;
+    std::istringstream is( str);
+    std::string item;
+    while ( std::getline( is, item, ',') ) {
+        std::istringstream iss( item);
+        unsigned int cpu = 0;
+        if ( ! ( iss >> cpu) ) {
+            throw std::invalid_argument("invalid processor list: " + str);
+        }
+        cpus.push_back( cpu);
+    }
+    return cpus;
+}
+
+// processors the benchmark may be bound to (affinity mask, cgroups)
+std::vector< unsigned int > usable_cpus() {
+    std::vector< unsigned int > cpus;
+    const unsigned int n = ( std::max)( std::thread::hardware_concurrency(), 1u);
+    for ( unsigned int i = 0; i < n; ++i) {
+        try {
+            bind_to_processor( i);
+            cpus.push_back( i);
+        } catch ( std::runtime_error const&) {
+        }
+    }
+    return cpus;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("rounds,n", boost::program_options::value< boost::uint64_t >( & rounds), "round trips (two hops) per sample")
+            ("repetitions,r", boost::program_options::value< boost::uint64_t >( & repetitions), "samples per processor pair")
+            ("warmup,w", boost::program_options::value< boost::uint64_t >( & warmup), "samples discarded before measuring")
+            ("working-set,s", boost::program_options::value< std::size_t >( & working_set), "bytes written by the continuation on each resume")
+            ("cpus,p", boost::program_options::value< std::string >( & cpu_list), "comma separated processors (default: all usable)")
+            ("json,o", boost::program_options::value< std::string >( & json_file), "write results as JSON to file ('-' for stdout)");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if ( 0 == rounds || 0 == repetitions) {
+            throw std::invalid_argument("rounds and repetitions must not be zero");
+        }
+
+        std::vector< unsigned int > cpus = cpu_list.empty() ? usable_cpus() : parse_cpus( cpu_list);
+        if ( cpus.empty() ) {
+            throw std::runtime_error("no processor to bind to");
+        }
+        // fail early instead of inside the benchmark threads
+        for ( unsigned int cpu : cpus) {
+            bind_to_processor( cpu);
+        }
+        std::ostream & os = "-" == json_file ? std::cerr : std::cout;
+        if ( 1 == cpus.size() ) {
+            os << "only one processor available: reporting the same-core baseline only\n";
+        }
+        std::vector< topology > topo;
+        for ( unsigned int cpu : cpus) {
+            topo.push_back( get_topology( cpu) );
+        }
+
+        // median latency of a hop in ns; row: processor resuming the
+        // continuation first, column: processor it migrates to
+        json_report report;
+        std::vector< std::vector< double > > matrix( cpus.size(), std::vector< double >( cpus.size(), 0) );
+        std::vector< std::vector< double > > per_relation( unknown + 1);
+        for ( std::size_t i = 0; i < cpus.size(); ++i) {
+            for ( std::size_t j = 0; j < cpus.size(); ++j) {
+                const relation rel = i == j
+                    ? same_cpu
+                    : get_relation( cpus[i], topo[i], cpus[j], topo[j]);
+                std::vector< double > samples = i == j
+                    ? measure_baseline( cpus[i])
+                    : measure_pair( cpus[i], cpus[j]);
+                std::ostringstream name;
+                name << "migration/" << cpus[i] << "->" << cpus[j];
+                json_report::extra_type extra;
+                extra.emplace_back( "from", cpus[i]);
+                extra.emplace_back( "to", cpus[j]);
+                extra.emplace_back( "relation", rel);
+                matrix[i][j] = report.add( name.str(), "ns", samples, extra).median;
+                per_relation[rel].push_back( matrix[i][j]);
+            }
+        }
+
+        os << "median latency of a hop in ns (row: from, column: to, diagonal: without migration)\n";
+        os << std::setw( 6) << "";
+        for ( unsigned int cpu : cpus) {
+            os << std::setw( 9) << cpu;
+        }
+        os << "\n";
+        os << std::fixed << std::setprecision( 1);
+        for ( std::size_t i = 0; i < cpus.size(); ++i) {
+            os << std::setw( 6) << cpus[i];
+            for ( std::size_t j = 0; j < cpus.size(); ++j) {
+                os << std::setw( 9) << matrix[i][j];
+            }
+            os << "\n";
+        }
+        for ( int r = same_cpu; r <= unknown; ++r) {
+            if ( per_relation[r].empty() ) {
+                continue;
+            }
+            statistics s = summarize( per_relation[r]);
+            os << std::setw( 14) << relation_name( static_cast< relation >( r) ) << ": "
+               << "min " << s.min << " ns, median " << s.median << " ns, max " << s.max
+               << " ns (" << s.count << " pairs)\n";
+        }
+
+        if ( "-" == json_file) {
+            report.write( std::cout);
+        } else if ( ! json_file.empty() ) {
+            std::ofstream ofs( json_file.c_str() );
+            if ( ! ofs) {
+                throw std::runtime_error("can not open " + json_file);
+            }
+            report.write( ofs);
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
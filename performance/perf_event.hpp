@@ -0,0 +1,161 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef PERF_EVENT_H
+#define PERF_EVENT_H
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+// hardware event counter of the calling thread (user space only); not
+// available if the platform, the CPU (e.g. inside a VM without PMU) or the
+// permissions (perf_event_paranoid) do not allow it
+//
+// If more events are counted than the PMU has registers, the kernel
+// multiplexes them; value() extrapolates to the whole measurement interval.
+class perf_counter {
+private:
+    int     fd_{ -1 };
+
+#if defined(__linux__)
+    static std::uint64_t cache_event( std::uint64_t cache) noexcept {
+        return cache
+            | ( PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+public:
+    enum event {
+        cycles,
+        instructions,
+        branch_misses,
+        cache_misses,
+        // read misses of the L1 data/instruction cache and the data TLB
+        l1d_misses,
+        l1i_misses,
+        dtlb_misses
+    };
+
+    static char const* name( event e) noexcept {
+        switch ( e) {
+        case cycles:
+            return "cycles";
+        case instructions:
+            return "instructions";
+        case branch_misses:
+            return "branch_misses";
+        case cache_misses:
+            return "cache_misses";
+        case l1d_misses:
+            return "l1d_misses";
+        case l1i_misses:
+            return "l1i_misses";
+        case dtlb_misses:
+            return "dtlb_misses";
+        }
+        return "unknown";
+    }
+
+    explicit perf_counter( event e) noexcept {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset( & attr, 0, sizeof( attr) );
+        attr.size = sizeof( attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        switch ( e) {
+        case cycles:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case instructions:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case branch_misses:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case cache_misses:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case l1d_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_event( PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case l1i_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_event( PERF_COUNT_HW_CACHE_L1I);
+            break;
+        case dtlb_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_event( PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        }
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast< int >( ::syscall( __NR_perf_event_open, & attr, 0, -1, -1, 0) );
+#else
+        ( void)e;
+#endif
+    }
+
+    ~perf_counter() {
+#if defined(__linux__)
+        if ( valid() ) {
+            ::close( fd_);
+        }
+#endif
+    }
+
+    perf_counter( perf_counter const&) = delete;
+    perf_counter & operator=( perf_counter const&) = delete;
+
+    bool valid() const noexcept {
+        return 0 <= fd_;
+    }
+
+    void start() noexcept {
+#if defined(__linux__)
+        if ( valid() ) {
+            ::ioctl( fd_, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl( fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() noexcept {
+#if defined(__linux__)
+        if ( valid() ) {
+            ::ioctl( fd_, PERF_EVENT_IOC_DISABLE, 0);
+        }
+#endif
+    }
+
+    std::uint64_t value() const noexcept {
+#if defined(__linux__)
+        // value, time enabled, time running
+        std::uint64_t v[3] = { 0, 0, 0 };
+        if ( ! valid() || sizeof( v) != ::read( fd_, v, sizeof( v) ) ) {
+            return 0;
+        }
+        if ( 0 != v[2] && v[2] < v[1]) {
+            // counter was multiplexed
+            return static_cast< std::uint64_t >( static_cast< double >( v[0]) * v[1] / v[2]);
+        }
+        return v[0];
+#else
+        return 0;
+#endif
+    }
+};
+
+#endif // PERF_EVENT_H
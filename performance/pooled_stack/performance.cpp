@@ -0,0 +1,196 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../clock.hpp"
+
+boost::uint64_t jobs = 1000000;
+boost::uint64_t threads = 4;
+
+namespace ctx = boost::context;
+
+static ctx::continuation foo( ctx::continuation && c) {
+    return std::move( c);
+}
+
+// every thread creates and destroys `jobs` continuations; the allocator is
+// passed as owning copy or as plain handle
+struct by_copy {
+    static void run( ctx::pooled_fixedsize_stack const& pool) {
+        for ( std::size_t i = 0; i < jobs; ++i) {
+            ctx::continuation c = ctx::callcc( std::allocator_arg, pool, foo);
+        }
+    }
+};
+
+struct by_handle {
+    static void run( ctx::pooled_fixedsize_stack const& pool) {
+        const ctx::pooled_fixedsize_stack::handle_type h = pool.handle();
+        for ( std::size_t i = 0; i < jobs; ++i) {
+            ctx::continuation c = ctx::callcc( std::allocator_arg, h, foo);
+        }
+    }
+};
+
+// allocates from a free list owned by one thread; the stacks of all free
+// lists are carved from one shared pool before the measurement, so the use
+// count of the pool is the only shared write while measuring. A copy of the
+// wrapped allocator is stored in each continuation
+template< typename Salloc >
+class carved {
+private:
+    Salloc                                  salloc_;
+    std::vector< ctx::stack_context >   *   free_;
+
+public:
+    carved( Salloc const& salloc, std::vector< ctx::stack_context > & free) :
+        salloc_( salloc),
+        free_( & free) {
+    }
+
+    ctx::stack_context allocate() {
+        if ( free_->empty() ) {
+            throw std::bad_alloc();
+        }
+        ctx::stack_context sctx = free_->back();
+        free_->pop_back();
+        return sctx;
+    }
+
+    void deallocate( ctx::stack_context & sctx) noexcept {
+        free_->push_back( sctx);
+    }
+};
+
+// all threads allocate from the same pool: the copies of the allocator
+// share (and contend on) the use count of the pool, the handles do not
+struct shared_copy {
+    static void run( ctx::pooled_fixedsize_stack const& pool, std::vector< ctx::stack_context > & free) {
+        const carved< ctx::pooled_fixedsize_stack > salloc( pool, free);
+        for ( std::size_t i = 0; i < jobs; ++i) {
+            ctx::continuation c = ctx::callcc( std::allocator_arg, salloc, foo);
+        }
+    }
+};
+
+struct shared_handle {
+    static void run( ctx::pooled_fixedsize_stack const& pool, std::vector< ctx::stack_context > & free) {
+        const carved< ctx::pooled_fixedsize_stack::handle_type > salloc( pool.handle(), free);
+        for ( std::size_t i = 0; i < jobs; ++i) {
+            ctx::continuation c = ctx::callcc( std::allocator_arg, salloc, foo);
+        }
+    }
+};
+
+template< typename Salloc >
+duration_type measure() {
+    // boost::pool is not thread-safe; one pool per thread, all of them
+    // created by the main thread (as a scheduler would do)
+    std::vector< ctx::pooled_fixedsize_stack > pools;
+    for ( std::size_t i = 0; i < threads; ++i) {
+        pools.emplace_back( ctx::stack_traits::default_size(), 4);
+    }
+    std::vector< std::thread > ts;
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < threads; ++i) {
+        ts.emplace_back( [&pools,i](){
+            Salloc::run( pools[i]);
+        });
+    }
+    for ( std::thread & t : ts) {
+        t.join();
+    }
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= jobs * threads;  // loops
+
+    return total;
+}
+
+template< typename Salloc >
+duration_type measure_shared() {
+    // boost::pool is not thread-safe; the main thread carves a few stacks
+    // per thread from the shared pool and returns them afterwards
+    const std::size_t carve = 4;
+    ctx::pooled_fixedsize_stack pool( ctx::stack_traits::default_size(), carve * threads);
+    std::vector< std::vector< ctx::stack_context > > free( threads);
+    for ( std::vector< ctx::stack_context > & f : free) {
+        for ( std::size_t i = 0; i < carve; ++i) {
+            f.push_back( pool.allocate() );
+        }
+    }
+    std::vector< std::thread > ts;
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < threads; ++i) {
+        ts.emplace_back( [&pool,&free,i](){
+            Salloc::run( pool, free[i]);
+        });
+    }
+    for ( std::thread & t : ts) {
+        t.join();
+    }
+    duration_type total = clock_type::now() - start;
+    total -= overhead_clock(); // overhead of measurement
+    total /= jobs * threads;  // loops
+
+    for ( std::vector< ctx::stack_context > & f : free) {
+        for ( ctx::stack_context & sctx : f) {
+            pool.deallocate( sctx);
+        }
+    }
+    return total;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("jobs,j", boost::program_options::value< boost::uint64_t >( & jobs), "continuations per thread")
+            ("threads,t", boost::program_options::value< boost::uint64_t >( & threads), "threads");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        boost::uint64_t res = measure< by_copy >().count();
+        std::cout << "pooled_fixedsize_stack: average of " << res << " nano seconds per continuation" << std::endl;
+        res = measure< by_handle >().count();
+        std::cout << "pooled_fixedsize_stack::handle_type: average of " << res << " nano seconds per continuation" << std::endl;
+        res = measure_shared< shared_copy >().count();
+        std::cout << "pooled_fixedsize_stack (shared pool): average of " << res << " nano seconds per continuation" << std::endl;
+        res = measure_shared< shared_handle >().count();
+        std::cout << "pooled_fixedsize_stack::handle_type (shared pool): average of " << res << " nano seconds per continuation" << std::endl;
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
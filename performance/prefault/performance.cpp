@@ -0,0 +1,139 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/prefaulted_stack.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+
+boost::uint64_t requests = 1000;
+boost::uint64_t touch_kb = 16;
+
+namespace ctx = boost::context;
+
+const std::size_t stack_size = 64 * 1024;
+const std::size_t max_touch = 32 * 1024;
+
+// keeps the compiler from removing the writes to the stack
+volatile char sink = 0;
+
+// handler using `touch_kb` KiB of its stack
+static ctx::continuation handler( ctx::continuation && c) {
+    volatile char buffer[max_touch];
+    const std::size_t size = ( std::min)( static_cast< std::size_t >( touch_kb * 1024), max_touch);
+    for ( std::size_t i = 0; i < size; i += 64) {
+        buffer[max_touch - 1 - i] = 1;
+    }
+    sink = buffer[max_touch - size];
+    return std::move( c);
+}
+
+struct result {
+    duration_type   average;
+    duration_type   p99;
+    duration_type   max;
+};
+
+// each request runs on its own stack, taken from `salloc`
+template< typename StackAllocator >
+result measure( StackAllocator salloc) {
+    std::vector< duration_type > latencies;
+    latencies.reserve( requests);
+    for ( boost::uint64_t i = 0; i < requests; ++i) {
+        time_point_type start( clock_type::now() );
+        ctx::callcc( std::allocator_arg, salloc, handler);
+        latencies.push_back( clock_type::now() - start);
+    }
+    result r;
+    duration_type total = duration_type::zero();
+    for ( duration_type d : latencies) {
+        total += d;
+    }
+    r.average = total / requests;
+    std::sort( latencies.begin(), latencies.end() );
+    r.p99 = latencies[( latencies.size() * 99) / 100];
+    r.max = latencies.back();
+    return r;
+}
+
+static void print( char const* name, result const& r) {
+    std::cout << name << ": average " << r.average.count() << " ns, p99 "
+              << r.p99.count() << " ns, max " << r.max.count() << " ns per request" << std::endl;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("requests,r", boost::program_options::value< boost::uint64_t >( & requests), "requests, each on a fresh stack")
+            ("touch,t", boost::program_options::value< boost::uint64_t >( & touch_kb), "KiB of stack used by each request");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        const std::size_t prefault_size = touch_kb * 1024 + 4096;
+
+        // fresh mapping per request; every touched page faults
+        print( "protected_fixedsize_stack", measure( ctx::protected_fixedsize_stack( stack_size) ) );
+
+        // one stack per request, all pre-faulted at startup
+        {
+            ctx::prefaulted_protected_fixedsize_stack salloc(
+                    prefault_size, false, ctx::protected_fixedsize_stack( stack_size) );
+            salloc.reserve( requests);
+            print( "prefaulted_protected_fixedsize_stack", measure( salloc) );
+        }
+
+        try {
+            ctx::prefaulted_protected_fixedsize_stack salloc(
+                    prefault_size, true, ctx::protected_fixedsize_stack( stack_size) );
+            salloc.reserve( requests);
+            print( "prefaulted_protected_fixedsize_stack (mlock)", measure( salloc) );
+        } catch ( std::bad_alloc const&) {
+            std::cout << "prefaulted_protected_fixedsize_stack (mlock): RLIMIT_MEMLOCK exceeded" << std::endl;
+        }
+
+        // steady state: the same stack is reused by every request
+        {
+            ctx::prefaulted_protected_fixedsize_stack salloc(
+                    prefault_size, false, ctx::protected_fixedsize_stack( stack_size) );
+            salloc.reserve( 1);
+            print( "steady state", measure( salloc) );
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,376 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// discrete-event simulation: each entity is a suspended continuation, resumed
+// when its next event is due; the delays between events are pseudo-random,
+// so the entities are resumed in pseudo-random order
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/context/slab_protected_stack.hpp>
+#include <boost/context/stack_traits.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+#include "../memory.hpp"
+#include "../perf_event.hpp"
+#include "../stats.hpp"
+
+namespace ctx = boost::context;
+
+std::string counts_list = "1000,10000,100000,1000000";
+boost::uint64_t events_per_entity = 10;
+boost::uint64_t min_events = 1000000;
+boost::uint64_t max_delay = 1000;
+boost::uint64_t stack_kb = 16;
+boost::uint64_t rss_limit_mb = 0;
+std::string allocator_name = "fixedsize";
+std::string json_file;
+
+// samples per simulation run
+const boost::uint64_t chunks = 20;
+
+struct event {
+    boost::uint64_t     time;
+    boost::uint64_t     id;
+
+    bool operator>( event const& other) const noexcept {
+        return time > other.time;
+    }
+};
+
+typedef std::priority_queue< event, std::vector< event >, std::greater< event > >   event_queue;
+
+std::ostream & table() {
+    return "-" == json_file ? std::cerr : std::cout;
+}
+
+inline
+boost::uint64_t xorshift( boost::uint64_t x) noexcept {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+inline
+boost::uint64_t seed( boost::uint64_t id) noexcept {
+    return id * UINT64_C( 0x9e3779b97f4a7c15) + 1;
+}
+
+// the state of an entity lives on its stack; each event advances the state
+// and yields the delay to the next event
+template< typename StackAllocator >
+ctx::continuation make_entity( StackAllocator const& salloc, boost::uint64_t id) {
+    return ctx::callcc( std::allocator_arg, salloc,
+            [id]( ctx::continuation && c) {
+                boost::uint64_t state = seed( id);
+                for (;;) {
+                    state = xorshift( state);
+                    c = c.resume( state % max_delay + 1);
+                }
+                return std::move( c);
+            });
+}
+
+// hardware events counted during a simulation run; events that can not be
+// counted on this platform are omitted
+class counters {
+private:
+    typedef std::pair< perf_counter::event, std::unique_ptr< perf_counter > >  counter_type;
+
+    std::vector< counter_type >     counters_;
+
+public:
+    counters() {
+        static const perf_counter::event events[] = {
+            perf_counter::cache_misses,
+            perf_counter::l1d_misses,
+            perf_counter::dtlb_misses
+        };
+        for ( perf_counter::event e : events) {
+            std::unique_ptr< perf_counter > c( new perf_counter( e) );
+            if ( c->valid() ) {
+                counters_.emplace_back( e, std::move( c) );
+            }
+        }
+    }
+
+    void start() noexcept {
+        for ( counter_type & c : counters_) {
+            c.second->start();
+        }
+    }
+
+    void stop() noexcept {
+        for ( counter_type & c : counters_) {
+            c.second->stop();
+        }
+    }
+
+    // counted events per simulated event
+    void add( json_report::extra_type & extra, std::string const& prefix, boost::uint64_t events) const {
+        for ( counter_type const& c : counters_) {
+            extra.emplace_back( prefix + perf_counter::name( c.first),
+                                static_cast< double >( c.second->value() ) / events);
+        }
+    }
+};
+
+// runs `events` events in `chunks` slices; each sample is the time per event
+// in ns of one slice
+template< typename Resume >
+std::vector< double > simulate( event_queue & q, boost::uint64_t events, Resume && resume) {
+    std::vector< double > samples;
+    const boost::uint64_t slice = ( std::max)( events / chunks, boost::uint64_t( 1) );
+    for ( boost::uint64_t done = 0; done < events; done += slice) {
+        const boost::uint64_t n = ( std::min)( slice, events - done);
+        time_point_type start( clock_type::now() );
+        for ( boost::uint64_t i = 0; i < n; ++i) {
+            const event ev = q.top();
+            q.pop();
+            q.push( event{ ev.time + resume( ev.id), ev.id });
+        }
+        samples.push_back( static_cast< double >( ( clock_type::now() - start).count() ) / n);
+    }
+    return samples;
+}
+
+// writes one line to `results`: the entry, the number of samples, the samples
+// and pairs of extra field and value
+template< typename StackAllocator >
+void measure( std::ostream & results, boost::uint64_t count, StackAllocator salloc) {
+    // entities
+    const std::size_t rss = resident_size();
+    const std::size_t limit = rss_limit( rss, rss_limit_mb);
+    std::vector< ctx::continuation > cs;
+    cs.reserve( count);
+    event_queue q;
+    std::string stopped;
+    time_point_type start( clock_type::now() );
+    try {
+        for ( boost::uint64_t id = 0; id < count; ++id) {
+            cs.push_back( make_entity( salloc, id) );
+            q.push( event{ cs.back().get_data< boost::uint64_t >(), id });
+            if ( 0 == ( id % 4096) && 0 != limit && resident_size() > limit) {
+                stopped = "RSS limit reached";
+                break;
+            }
+        }
+    } catch ( std::bad_alloc const&) {
+        stopped = "allocation failed";
+    }
+    const double create = static_cast< double >( ( clock_type::now() - start).count() ) / ( std::max)( cs.size(), std::size_t( 1) );
+    const std::size_t entities = cs.size();
+    const std::size_t grown = resident_size() - ( std::min)( rss, resident_size() );
+    const boost::uint64_t events = ( std::max)( events_per_entity * entities, min_events);
+
+    counters cnt;
+    cnt.start();
+    std::vector< double > samples = simulate( q, events,
+            [&cs]( boost::uint64_t id) {
+                cs[id] = cs[id].resume();
+                return cs[id].get_data< boost::uint64_t >();
+            });
+    cnt.stop();
+
+    // baseline: the same simulation with the state of the entities in an
+    // array instead of on their stacks
+    std::vector< boost::uint64_t > states( entities);
+    event_queue qb;
+    for ( boost::uint64_t id = 0; id < entities; ++id) {
+        states[id] = xorshift( seed( id) );
+        qb.push( event{ states[id] % max_delay + 1, id });
+    }
+    counters cntb;
+    cntb.start();
+    std::vector< double > baseline = simulate( qb, events,
+            [&states]( boost::uint64_t id) {
+                states[id] = xorshift( states[id]);
+                return states[id] % max_delay + 1;
+            });
+    cntb.stop();
+
+    json_report::extra_type hw;
+    cnt.add( hw, "", events);
+    cntb.add( hw, "baseline_", events);
+    json_report::extra_type extra;
+    extra.emplace_back( "entities", static_cast< double >( entities) );
+    extra.emplace_back( "events", static_cast< double >( events) );
+    extra.emplace_back( "create", create);
+    extra.emplace_back( "rss", static_cast< double >( grown) );
+    extra.emplace_back( "baseline", summarize( baseline).median);
+    extra.insert( extra.end(), hw.begin(), hw.end() );
+    results << std::setprecision( 17) << "simulation/" << allocator_name << "/" << count << " " << samples.size();
+    for ( double x : samples) {
+        results << " " << x;
+    }
+    for ( auto const& x : extra) {
+        results << " " << x.first << " " << x.second;
+    }
+    results << "\n";
+    const statistics s = summarize( samples);
+    const statistics b = summarize( baseline);
+    table() << std::setw( 9) << entities
+            << std::fixed << std::setprecision( 0)
+            << std::setw( 8) << create << " ns/create"
+            << std::setw( 8) << grown / 1024. / 1024. << " MiB RSS"
+            << std::setw( 7) << grown / ( std::max)( double( entities), 1.) << " B/entity"
+            << std::setw( 11) << 1e9 / s.median << " events/s"
+            << std::setprecision( 1)
+            << std::setw( 8) << s.median << " ns/event (baseline " << b.median << ")";
+    for ( auto const& x : hw) {
+        table() << "  " << x.first << " " << std::setprecision( 2) << x.second;
+    }
+    if ( ! stopped.empty() ) {
+        table() << "  (" << stopped << ")";
+    }
+    table() << std::endl;
+    // destroying the suspended continuations unwinds their stacks
+}
+
+// each count runs in a fresh process: memory kept by the heap or the pool
+// after a smaller count would hide the growth of the RSS
+template< typename StackAllocator >
+void run( json_report & report, boost::uint64_t count, StackAllocator const& salloc) {
+    const child_result r = in_child_process( [&]( std::ostream & results) {
+                measure( results, count, salloc);
+            });
+    if ( 0 != r.signal) {
+        // e.g. killed by the OOM killer
+        table() << std::setw( 9) << count << ": terminated by signal " << r.signal << std::endl;
+    }
+    std::istringstream is( r.output);
+    std::string line;
+    while ( std::getline( is, line) ) {
+        std::istringstream ls( line);
+        std::string entry;
+        std::size_t n = 0;
+        if ( ! ( ls >> entry >> n) ) {
+            continue;
+        }
+        std::vector< double > samples( n);
+        for ( double & x : samples) {
+            ls >> x;
+        }
+        json_report::extra_type extra;
+        std::string field;
+        double v = 0;
+        while ( ls >> field >> v) {
+            extra.emplace_back( field, v);
+        }
+        report.add( entry, "ns/event", samples, extra);
+    }
+}
+
+std::vector< boost::uint64_t > parse_counts( std::string const& str) {
+    std::vector< boost::uint64_t > v;
+    std::istringstream is( str);
+    std::string item;
+    while ( std::getline( is, item, ',') ) {
+        std::istringstream iss( item);
+        boost::uint64_t n = 0;
+        if ( ! ( iss >> n) || 0 == n) {
+            throw std::invalid_argument("invalid list of counts: " + str);
+        }
+        v.push_back( n);
+    }
+    if ( v.empty() ) {
+        throw std::invalid_argument("invalid list of counts: " + str);
+    }
+    return v;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("entities,n", boost::program_options::value< std::string >( & counts_list), "comma separated numbers of entities (continuations)")
+            ("events,e", boost::program_options::value< boost::uint64_t >( & events_per_entity), "events per entity")
+            ("min-events,m", boost::program_options::value< boost::uint64_t >( & min_events), "minimal number of events per run")
+            ("delay,d", boost::program_options::value< boost::uint64_t >( & max_delay), "maximal delay between two events of an entity")
+            ("stack,s", boost::program_options::value< boost::uint64_t >( & stack_kb), "stack size in KiB")
+            ("allocator,a", boost::program_options::value< std::string >( & allocator_name), "fixedsize, pooled, protected or slab")
+            ("rss-limit,l", boost::program_options::value< boost::uint64_t >( & rss_limit_mb), "stop creating at this RSS in MiB (default: half of the free memory)")
+            ("json,o", boost::program_options::value< std::string >( & json_file), "write results as JSON to file ('-' for stdout)");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if ( 0 == max_delay) {
+            throw std::invalid_argument("delay must not be zero");
+        }
+
+        const std::size_t stack_size = stack_kb * 1024;
+        json_report report;
+        table() << allocator_name << " stacks of " << stack_kb << " KiB" << std::endl;
+        for ( boost::uint64_t count : parse_counts( counts_list) ) {
+            if ( "fixedsize" == allocator_name) {
+                run( report, count, ctx::fixedsize_stack( stack_size) );
+            } else if ( "pooled" == allocator_name) {
+                run( report, count, ctx::pooled_fixedsize_stack( stack_size) );
+            } else if ( "protected" == allocator_name) {
+                run( report, count, ctx::protected_fixedsize_stack( stack_size) );
+            } else if ( "slab" == allocator_name) {
+                run( report, count, ctx::slab_protected_stack( stack_size) );
+            } else {
+                throw std::invalid_argument("unknown allocator: " + allocator_name);
+            }
+        }
+        if ( ! perf_counter( perf_counter::cache_misses).valid() ) {
+            table() << "(hardware counters not available)" << std::endl;
+        }
+
+        if ( "-" == json_file) {
+            report.write( std::cout);
+        } else if ( ! json_file.empty() ) {
+            std::ofstream os( json_file.c_str() );
+            if ( ! os) {
+                throw std::runtime_error("can not open " + json_file);
+            }
+            report.write( os);
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,93 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/context/slab_protected_stack.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+
+boost::uint64_t continuations = 100000;
+boost::uint64_t stack_kb = 16;
+boost::uint64_t slab_stacks = 256;
+
+namespace ctx = boost::context;
+
+static ctx::continuation suspended( ctx::continuation && c) {
+    return c.resume();
+}
+
+// keeps `continuations` guarded continuations alive at the same time
+template< typename StackAllocator >
+void measure( char const* name, StackAllocator salloc) {
+    const std::size_t vmas = ctx::process_vma_count();
+    std::vector< ctx::continuation > cs;
+    cs.reserve( continuations);
+    time_point_type start( clock_type::now() );
+    try {
+        for ( boost::uint64_t i = 0; i < continuations; ++i) {
+            cs.push_back( ctx::make_continuation( std::allocator_arg, salloc, suspended) );
+        }
+    } catch ( std::bad_alloc const&) {
+        std::cout << name << ": allocation failed after " << cs.size() << " continuations" << std::endl;
+    }
+    duration_type create = ( clock_type::now() - start) / ( std::max)( cs.size(), std::size_t( 1) );
+    std::cout << name << ": " << cs.size() << " continuations, average of " << create.count()
+              << " nano seconds per creation, " << ctx::process_vma_count() - vmas
+              << " additional VMAs (limit " << ctx::max_vma_count() << ")" << std::endl;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("continuations,n", boost::program_options::value< boost::uint64_t >( & continuations), "continuations alive at the same time")
+            ("stack,s", boost::program_options::value< boost::uint64_t >( & stack_kb), "stack size in KiB")
+            ("slab,b", boost::program_options::value< boost::uint64_t >( & slab_stacks), "stacks per slab");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        const std::size_t stack_size = stack_kb * 1024;
+        measure( "protected_fixedsize_stack", ctx::protected_fixedsize_stack( stack_size) );
+        {
+            ctx::slab_protected_stack salloc( stack_size, slab_stacks);
+            measure( "slab_protected_stack", salloc);
+            std::cout << "slab_protected_stack: at most " << salloc.vma_count() << " VMAs used by slabs, guard regions "
+                      << ( salloc.guard_regions() ? "supported" : "not supported (mprotect)") << std::endl;
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
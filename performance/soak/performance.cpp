@@ -0,0 +1,283 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// long running churn of continuations with mixed lifetimes and stack depths;
+// samples RSS, heap retention and switch latency periodically
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+# include <malloc.h>
+#endif
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/context/slab_protected_stack.hpp>
+#include <boost/context/stack_traits.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+#include "../memory.hpp"
+#include "../stats.hpp"
+
+namespace ctx = boost::context;
+
+boost::uint64_t duration_s = 60;
+boost::uint64_t interval_s = 5;
+boost::uint64_t population = 10000;
+boost::uint64_t stack_kb = 64;
+boost::uint64_t seed = 42;
+std::string allocator_name = "fixedsize";
+std::string json_file;
+
+// every n-th resume is timed
+const boost::uint64_t sample_rate = 16;
+
+std::ostream & table() {
+    return "-" == json_file ? std::cerr : std::cout;
+}
+
+// free memory kept by malloc (glibc), 0 if unknown
+std::size_t heap_free() {
+#if defined(__GLIBC__) && ( 2 < __GLIBC__ || 33 <= __GLIBC_MINOR__)
+    return ::mallinfo2().fordblks;
+#else
+    return 0;
+#endif
+}
+
+// uses `frames` KiB of the stack, then suspends `switches` times
+static ctx::continuation run( ctx::continuation && c, unsigned int frames, boost::uint64_t switches) {
+    if ( 0 < frames) {
+        volatile char buffer[1024];
+        buffer[0] = 0;
+        c = run( std::move( c), frames - 1, switches);
+        buffer[sizeof( buffer) - 1] = 0;
+        return std::move( c);
+    }
+    for ( boost::uint64_t i = 0; i < switches; ++i) {
+        c = c.resume();
+    }
+    return std::move( c);
+}
+
+// a continuation and the number of resumes after which it gets destroyed
+// while suspended (0: runs until it finishes)
+struct slot {
+    ctx::continuation   c{};
+    boost::uint64_t     kill_after{ 0 };
+};
+
+// lifetimes: 90% short (1..10 switches), 9% medium (100..1000), 1% long
+// (10000..100000); stack usage: mostly shallow, 5% up to half of the stack;
+// 10% are destroyed while suspended
+class workload {
+private:
+    std::minstd_rand                                    rng_;
+    std::uniform_int_distribution< unsigned int >       percent_{ 0, 99 };
+    std::uniform_int_distribution< boost::uint64_t >    short_{ 1, 10 };
+    std::uniform_int_distribution< boost::uint64_t >    medium_{ 100, 1000 };
+    std::uniform_int_distribution< boost::uint64_t >    long_{ 10000, 100000 };
+    std::uniform_int_distribution< unsigned int >       shallow_{ 0, 4 };
+    std::uniform_int_distribution< unsigned int >       deep_;
+
+public:
+    explicit workload( boost::uint64_t seed, std::size_t stack_size) :
+        rng_( static_cast< std::minstd_rand::result_type >( seed) ),
+        deep_( 0, static_cast< unsigned int >( stack_size / 2 / 1024) ) {
+    }
+
+    boost::uint64_t lifetime() {
+        const unsigned int p = percent_( rng_);
+        return 90 > p ? short_( rng_) : ( 99 > p ? medium_( rng_) : long_( rng_) );
+    }
+
+    unsigned int frames() {
+        return 5 > percent_( rng_) ? deep_( rng_) : shallow_( rng_);
+    }
+
+    boost::uint64_t kill_after( boost::uint64_t lifetime) {
+        return 10 > percent_( rng_) ? lifetime / 2 + 1 : 0;
+    }
+
+    std::size_t pick( std::size_t n) {
+        return std::uniform_int_distribution< std::size_t >( 0, n - 1)( rng_);
+    }
+};
+
+template< typename StackAllocator >
+void soak( json_report & report, StackAllocator salloc) {
+    const std::size_t stack_size = stack_kb * 1024;
+    const std::size_t rss0 = resident_size();
+    workload w( seed, stack_size);
+    std::vector< slot > slots( population);
+    boost::uint64_t created = 0, finished = 0, destroyed = 0, resumes = 0, live = 0;
+    std::vector< double > latencies;
+    const time_point_type begin( clock_type::now() );
+    const boost::chrono::seconds interval( interval_s);
+    time_point_type next( begin + interval);
+    table() << std::setw( 8) << "time s" << std::setw( 8) << "live"
+            << std::setw( 11) << "created/s" << std::setw( 11) << "RSS MiB"
+            << std::setw( 12) << "heap free"
+            << std::setw( 9) << "p50 ns" << std::setw( 9) << "p99 ns"
+            << std::setw( 10) << "p99.9 ns" << std::setw( 10) << "max ns" << std::endl;
+    boost::uint64_t created_before = 0;
+    for (;;) {
+        for ( int k = 0; k < 1024; ++k) {
+            slot & s = slots[w.pick( slots.size() )];
+            if ( ! s.c) {
+                const boost::uint64_t lifetime = w.lifetime();
+                const unsigned int frames = w.frames();
+                s.c = ctx::callcc( std::allocator_arg, salloc,
+                        [frames,lifetime]( ctx::continuation && c) {
+                            return run( std::move( c), frames, lifetime);
+                        });
+                s.kill_after = w.kill_after( lifetime);
+                ++created;
+                ++live;
+                continue;
+            }
+            if ( 0 == ( ++resumes % sample_rate) ) {
+                time_point_type start( clock_type::now() );
+                s.c = s.c.resume();
+                latencies.push_back( static_cast< double >( ( clock_type::now() - start).count() ) );
+            } else {
+                s.c = s.c.resume();
+            }
+            if ( ! s.c) {
+                ++finished;
+                --live;
+            } else if ( 0 != s.kill_after && 0 == --s.kill_after) {
+                // unwinds the stack
+                s.c = ctx::continuation{};
+                ++destroyed;
+                --live;
+            }
+        }
+        const time_point_type now( clock_type::now() );
+        if ( now < next) {
+            continue;
+        }
+        const double t = boost::chrono::duration_cast< boost::chrono::duration< double > >( now - begin).count();
+        const statistics st = summarize( latencies);
+        const std::size_t rss = resident_size();
+        json_report::extra_type extra;
+        extra.emplace_back( "time", t);
+        extra.emplace_back( "live", static_cast< double >( live) );
+        extra.emplace_back( "created", static_cast< double >( created) );
+        extra.emplace_back( "finished", static_cast< double >( finished) );
+        extra.emplace_back( "destroyed", static_cast< double >( destroyed) );
+        extra.emplace_back( "rss", static_cast< double >( rss) );
+        extra.emplace_back( "heap_free", static_cast< double >( heap_free() ) );
+        extra.emplace_back( "vmas", static_cast< double >( ctx::process_vma_count() ) );
+        std::ostringstream name;
+        name << "soak/" << allocator_name << "/" << static_cast< boost::uint64_t >( t + 0.5);
+        report.add( name.str(), "ns/resume", st, extra);
+        table() << std::fixed << std::setprecision( 0)
+                << std::setw( 8) << t << std::setw( 8) << live
+                << std::setw( 11) << ( created - created_before) / static_cast< double >( interval_s)
+                << std::setprecision( 1)
+                << std::setw( 11) << rss / 1024. / 1024.
+                << std::setw( 12) << heap_free() / 1024. / 1024.
+                << std::setw( 9) << st.median << std::setw( 9) << st.p99
+                << std::setw( 10) << st.p999 << std::setw( 10) << st.max << std::endl;
+        created_before = created;
+        latencies.clear();
+        next += interval;
+        if ( now - begin >= boost::chrono::seconds( duration_s) ) {
+            break;
+        }
+    }
+    // memory kept by the allocator after all continuations are gone
+    slots.clear();
+    const std::size_t rss = resident_size();
+    json_report::extra_type extra;
+    extra.emplace_back( "rss", static_cast< double >( rss) );
+    extra.emplace_back( "retained", static_cast< double >( rss - ( std::min)( rss0, rss) ) );
+    extra.emplace_back( "heap_free", static_cast< double >( heap_free() ) );
+    report.add( "soak/" + allocator_name + "/teardown", "bytes", statistics(), extra);
+    table() << "after destroying all continuations: RSS " << rss / 1024. / 1024. << " MiB, "
+            << ( rss - ( std::min)( rss0, rss) ) / 1024. / 1024. << " MiB retained since start, heap free "
+            << heap_free() / 1024. / 1024. << " MiB" << std::endl;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("duration,t", boost::program_options::value< boost::uint64_t >( & duration_s), "run time in seconds")
+            ("interval,i", boost::program_options::value< boost::uint64_t >( & interval_s), "seconds between two samples")
+            ("population,n", boost::program_options::value< boost::uint64_t >( & population), "slots for continuations alive at the same time")
+            ("stack,s", boost::program_options::value< boost::uint64_t >( & stack_kb), "stack size in KiB")
+            ("allocator,a", boost::program_options::value< std::string >( & allocator_name), "fixedsize, pooled, protected or slab")
+            ("seed", boost::program_options::value< boost::uint64_t >( & seed), "seed of the pseudo-random workload")
+            ("json,o", boost::program_options::value< std::string >( & json_file), "write the time series as JSON to file ('-' for stdout)");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if ( 0 == interval_s || 0 == population) {
+            throw std::invalid_argument("interval and population must not be zero");
+        }
+
+        const std::size_t stack_size = stack_kb * 1024;
+        json_report report;
+        if ( "fixedsize" == allocator_name) {
+            soak( report, ctx::fixedsize_stack( stack_size) );
+        } else if ( "pooled" == allocator_name) {
+            soak( report, ctx::pooled_fixedsize_stack( stack_size) );
+        } else if ( "protected" == allocator_name) {
+            soak( report, ctx::protected_fixedsize_stack( stack_size) );
+        } else if ( "slab" == allocator_name) {
+            soak( report, ctx::slab_protected_stack( stack_size) );
+        } else {
+            throw std::invalid_argument("unknown allocator: " + allocator_name);
+        }
+
+        if ( "-" == json_file) {
+            report.write( std::cout);
+        } else if ( ! json_file.empty() ) {
+            std::ofstream os( json_file.c_str() );
+            if ( ! os) {
+                throw std::runtime_error("can not open " + json_file);
+            }
+            report.write( os);
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
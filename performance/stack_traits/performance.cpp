@@ -0,0 +1,117 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/context/stack_context.hpp>
+#include <boost/context/stack_traits.hpp>
+#include <boost/context/static_stack_traits.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+
+boost::uint64_t jobs = 1000000;
+
+namespace ctx = boost::context;
+
+const std::size_t page_size = 4096;
+const std::size_t stack_size = 64 * 1024;
+
+typedef ctx::static_stack_traits< page_size, stack_size, 8 * 1024 >   static_traits;
+
+template< typename Traits >
+duration_type measure_traits() {
+    std::size_t sum = 0;
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < jobs; ++i) {
+        sum += Traits::page_size() + Traits::default_size() + ( Traits::is_unbounded() ? 1 : 0);
+        // keep the loop from being folded
+        __asm__ __volatile__ ("" : "+r" (sum) :: "memory");
+    }
+    duration_type total = clock_type::now() - start;
+    if ( 0 == sum) {
+        throw std::logic_error("unexpected sum");
+    }
+    return total / jobs;
+}
+
+// allocate() and deallocate() of one stack with the default size
+template< typename StackAllocator >
+duration_type measure_allocator() {
+    StackAllocator salloc;
+    // warm-up; the first allocation pays for page faults
+    ctx::stack_context sctx = salloc.allocate();
+    salloc.deallocate( sctx);
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < jobs; ++i) {
+        sctx = salloc.allocate();
+        salloc.deallocate( sctx);
+    }
+    return ( clock_type::now() - start) / jobs;
+}
+
+static void print( char const* name, duration_type d) {
+    std::cout << name << ": average of " << d.count() << " nano seconds" << std::endl;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("jobs,j", boost::program_options::value< boost::uint64_t >( & jobs), "jobs to run");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        print( "stack_traits", measure_traits< ctx::stack_traits >() );
+        print( "cached_stack_traits", measure_traits< ctx::cached_stack_traits >() );
+        print( "static_stack_traits", measure_traits< static_traits >() );
+
+        print( "fixedsize_stack< stack_traits >",
+               measure_allocator< ctx::basic_fixedsize_stack< ctx::stack_traits > >() );
+        print( "fixedsize_stack< cached_stack_traits >",
+               measure_allocator< ctx::basic_fixedsize_stack< ctx::cached_stack_traits > >() );
+        print( "fixedsize_stack< static_stack_traits >",
+               measure_allocator< ctx::basic_fixedsize_stack< static_traits > >() );
+
+        print( "protected_fixedsize_stack< stack_traits >",
+               measure_allocator< ctx::basic_protected_fixedsize_stack< ctx::stack_traits > >() );
+        print( "protected_fixedsize_stack< cached_stack_traits >",
+               measure_allocator< ctx::basic_protected_fixedsize_stack< ctx::cached_stack_traits > >() );
+        // the guard page must match the page size of the system
+        if ( page_size == ctx::stack_traits::page_size() ) {
+            print( "protected_fixedsize_stack< static_stack_traits >",
+                   measure_allocator< ctx::basic_protected_fixedsize_stack< static_traits > >() );
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
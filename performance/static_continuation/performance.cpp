@@ -0,0 +1,131 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/static_continuation.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+
+boost::uint64_t generators = 10000;
+boost::uint64_t rounds = 10;
+
+namespace ctx = boost::context;
+
+const std::size_t stack_size = ctx::static_continuation_min_stack;
+
+typedef ctx::static_continuation< stack_size >  static_generator;
+
+static ctx::continuation generate( ctx::continuation && c) {
+    for ( boost::uint64_t i = 0;; ++i) {
+        c = c.resume( i);
+    }
+    return std::move( c);
+}
+
+struct result {
+    duration_type   create;
+    duration_type   resume;
+};
+
+// all generators live in one array, stacks included
+result measure_static() {
+    result r;
+    time_point_type start( clock_type::now() );
+    std::unique_ptr< static_generator[] > gs( new static_generator[generators]);
+    for ( std::size_t i = 0; i < generators; ++i) {
+        gs[i].reset( generate);
+    }
+    r.create = ( clock_type::now() - start) / generators;
+    boost::uint64_t sum = 0;
+    start = clock_type::now();
+    for ( std::size_t n = 0; n < rounds; ++n) {
+        for ( std::size_t i = 0; i < generators; ++i) {
+            sum += gs[i].resume().get_data< boost::uint64_t >();
+        }
+    }
+    r.resume = ( clock_type::now() - start) / ( generators * rounds);
+    if ( generators * rounds * ( rounds - 1) / 2 != sum) {
+        throw std::logic_error("unexpected sum");
+    }
+    return r;
+}
+
+// each generator has its own stack from the free-store
+result measure_fixedsize() {
+    result r;
+    ctx::fixedsize_stack salloc( stack_size);
+    std::vector< ctx::continuation > gs;
+    gs.reserve( generators);
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < generators; ++i) {
+        gs.push_back( ctx::make_continuation( std::allocator_arg, salloc, generate) );
+    }
+    r.create = ( clock_type::now() - start) / generators;
+    boost::uint64_t sum = 0;
+    start = clock_type::now();
+    for ( std::size_t n = 0; n < rounds; ++n) {
+        for ( std::size_t i = 0; i < generators; ++i) {
+            gs[i] = gs[i].resume();
+            sum += gs[i].get_data< boost::uint64_t >();
+        }
+    }
+    r.resume = ( clock_type::now() - start) / ( generators * rounds);
+    if ( generators * rounds * ( rounds - 1) / 2 != sum) {
+        throw std::logic_error("unexpected sum");
+    }
+    return r;
+}
+
+static void print( char const* name, result const& r) {
+    std::cout << name << ": create " << r.create.count() << " ns, resume "
+              << r.resume.count() << " ns per generator" << std::endl;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("generators,g", boost::program_options::value< boost::uint64_t >( & generators), "generators resumed round-robin")
+            ("rounds,r", boost::program_options::value< boost::uint64_t >( & rounds), "values taken from each generator");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        print( "static_continuation", measure_static() );
+        print( "continuation + fixedsize_stack", measure_fixedsize() );
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
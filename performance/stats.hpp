@@ -0,0 +1,185 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/config.hpp>
+#include <boost/version.hpp>
+
+// summary of a series of samples
+struct statistics {
+    std::size_t     count{ 0 };
+    double          min{ 0 };
+    double          median{ 0 };
+    double          p99{ 0 };
+    double          p999{ 0 };
+    double          max{ 0 };
+    double          mean{ 0 };
+    double          stddev{ 0 };
+    // coefficient of variation: stddev / mean
+    double          cv{ 0 };
+};
+
+// nearest-rank percentile of sorted samples; `p` in [0, 1]
+inline
+double percentile( std::vector< double > const& sorted, double p) {
+    if ( sorted.empty() ) {
+        return 0;
+    }
+    const std::size_t rank = static_cast< std::size_t >( std::ceil( p * sorted.size() ) );
+    return sorted[( std::max)( rank, std::size_t( 1) ) - 1];
+}
+
+inline
+statistics summarize( std::vector< double > samples) {
+    statistics s;
+    s.count = samples.size();
+    if ( samples.empty() ) {
+        return s;
+    }
+    std::sort( samples.begin(), samples.end() );
+    s.min = samples.front();
+    s.max = samples.back();
+    s.median = percentile( samples, 0.5);
+    s.p99 = percentile( samples, 0.99);
+    s.p999 = percentile( samples, 0.999);
+    double sum = 0;
+    for ( double v : samples) {
+        sum += v;
+    }
+    s.mean = sum / samples.size();
+    double sq = 0;
+    for ( double v : samples) {
+        sq += ( v - s.mean) * ( v - s.mean);
+    }
+    s.stddev = 1 < samples.size() ? std::sqrt( sq / ( samples.size() - 1) ) : 0;
+    s.cv = 0 != s.mean ? s.stddev / s.mean : 0;
+    return s;
+}
+
+inline
+void json_string( std::ostream & os, std::string const& str) {
+    os << '"';
+    for ( char c : str) {
+        switch ( c) {
+        case '"':
+            os << "\\\"";
+            break;
+        case '\\':
+            os << "\\\\";
+            break;
+        case '\n':
+            os << "\\n";
+            break;
+        default:
+            if ( 0x20 > static_cast< unsigned char >( c) ) {
+                os << ' ';
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+}
+
+// results of a benchmark run; written as JSON
+//
+// {
+//   "context": { "boost_version": ..., "compiler": ..., "platform": ..., "timestamp": ... },
+//   "benchmarks": [
+//     { "name": ..., "unit": ..., "count": ..., "min": ..., "median": ..., "p99": ...,
+//       "p999": ..., "max": ..., "mean": ..., "stddev": ..., "cv": ..., <extra values>,
+//       "samples": [ ... ] }, ...
+//   ]
+// }
+class json_report {
+public:
+    typedef std::vector< std::pair< std::string, double > >   extra_type;
+
+private:
+    struct entry {
+        std::string             name;
+        std::string             unit;
+        statistics              stats;
+        extra_type              extra;
+        std::vector< double >   samples;
+    };
+
+    std::vector< entry >    entries_{};
+
+    static void value( std::ostream & os, char const* key, double v) {
+        os << ", ";
+        json_string( os, key);
+        // NaN and infinity are not valid JSON
+        if ( std::isfinite( v) ) {
+            os << ": " << v;
+        } else {
+            os << ": null";
+        }
+    }
+
+public:
+    statistics const& add( std::string const& name, std::string const& unit,
+                           std::vector< double > const& samples, extra_type const& extra = extra_type() ) {
+        entries_.push_back( entry{ name, unit, summarize( samples), extra, samples });
+        return entries_.back().stats;
+    }
+
+    // without the samples, e.g. for long running measurements
+    void add( std::string const& name, std::string const& unit,
+              statistics const& stats, extra_type const& extra = extra_type() ) {
+        entries_.push_back( entry{ name, unit, stats, extra, std::vector< double >() });
+    }
+
+    void write( std::ostream & os) const {
+        const std::streamsize precision = os.precision( 10);
+        os << "{\n  \"context\": { \"boost_version\": ";
+        json_string( os, BOOST_LIB_VERSION);
+        os << ", \"compiler\": ";
+        json_string( os, BOOST_COMPILER);
+        os << ", \"platform\": ";
+        json_string( os, BOOST_PLATFORM);
+        os << ", \"timestamp\": " << static_cast< long long >( std::time( nullptr) ) << " },\n";
+        os << "  \"benchmarks\": [";
+        for ( std::size_t i = 0; i < entries_.size(); ++i) {
+            entry const& e = entries_[i];
+            os << ( 0 == i ? "\n" : ",\n") << "    { \"name\": ";
+            json_string( os, e.name);
+            os << ", \"unit\": ";
+            json_string( os, e.unit);
+            os << ", \"count\": " << e.stats.count;
+            value( os, "min", e.stats.min);
+            value( os, "median", e.stats.median);
+            value( os, "p99", e.stats.p99);
+            value( os, "p999", e.stats.p999);
+            value( os, "max", e.stats.max);
+            value( os, "mean", e.stats.mean);
+            value( os, "stddev", e.stats.stddev);
+            value( os, "cv", e.stats.cv);
+            for ( auto const& x : e.extra) {
+                value( os, x.first.c_str(), x.second);
+            }
+            os << ",\n      \"samples\": [";
+            for ( std::size_t j = 0; j < e.samples.size(); ++j) {
+                os << ( 0 == j ? "" : ", ") << e.samples[j];
+            }
+            os << "] }";
+        }
+        os << "\n  ]\n}\n";
+        os.precision( precision);
+    }
+};
+
+#endif // STATS_H
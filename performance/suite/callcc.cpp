@@ -0,0 +1,38 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <utility>
+
+#include <boost/context/continuation.hpp>
+
+#include "suite.hpp"
+
+namespace ctx = boost::context;
+
+class callcc_bench {
+private:
+    ctx::continuation   c_;
+
+public:
+    callcc_bench() :
+        c_( ctx::callcc(
+                []( ctx::continuation && c) {
+                    while ( true) {
+                        c = c.resume();
+                    }
+                    return std::move( c);
+                }) ) {
+    }
+
+    void run( std::size_t n) {
+        for ( std::size_t i = 0; i < n; ++i) {
+            c_ = c_.resume();
+        }
+    }
+};
+
+void measure_callcc( json_report & report, double overhead) {
+    measure< callcc_bench >( report, "callcc", overhead);
+}
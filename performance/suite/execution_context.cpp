@@ -0,0 +1,69 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <utility>
+
+#include <boost/context/execution_context.hpp>
+
+#include "suite.hpp"
+
+namespace ctx = boost::context;
+
+#if defined(BOOST_EXECUTION_CONTEXT) && (BOOST_EXECUTION_CONTEXT == 1)
+// execution_context v1 requires the library built with
+// BOOST_EXECUTION_CONTEXT=1; v1 and v2 are mutually exclusive
+class ecv1_bench {
+private:
+    ctx::execution_context      main_;
+    ctx::execution_context      ctx_;
+
+public:
+    ecv1_bench() :
+        main_( ctx::execution_context::current() ),
+        ctx_( [this](void *) {
+                while ( true) {
+                    main_();
+                }
+            }) {
+        ctx_();
+    }
+
+    void run( std::size_t n) {
+        for ( std::size_t i = 0; i < n; ++i) {
+            ctx_();
+        }
+    }
+};
+#else
+class ecv2_bench {
+private:
+    ctx::execution_context< void >  ctx_;
+
+public:
+    ecv2_bench() :
+        ctx_( []( ctx::execution_context< void > && ctx) {
+                while ( true) {
+                    ctx = ctx();
+                }
+                return std::move( ctx);
+            }) {
+        ctx_ = ctx_();
+    }
+
+    void run( std::size_t n) {
+        for ( std::size_t i = 0; i < n; ++i) {
+            ctx_ = ctx_();
+        }
+    }
+};
+#endif
+
+void measure_execution_context( json_report & report, double overhead) {
+#if defined(BOOST_EXECUTION_CONTEXT) && (BOOST_EXECUTION_CONTEXT == 1)
+    measure< ecv1_bench >( report, "ecv1", overhead);
+#else
+    measure< ecv2_bench >( report, "ecv2", overhead);
+#endif
+}
@@ -0,0 +1,53 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <boost/context/detail/fcontext.hpp>
+
+#include "suite.hpp"
+
+namespace ctx = boost::context;
+
+// jump_fcontext() in a tight loop
+class fcontext_bench {
+private:
+    void                    *   stack_;
+    ctx::detail::transfer_t     t_;
+
+    static void loop( ctx::detail::transfer_t t) {
+        while ( true) {
+            t = ctx::detail::jump_fcontext( t.fctx, 0);
+        }
+    }
+
+public:
+    fcontext_bench() :
+        stack_( std::malloc( stack_size) ) {
+        if ( ! stack_) {
+            throw std::bad_alloc();
+        }
+        t_ = ctx::detail::jump_fcontext(
+                ctx::detail::make_fcontext( static_cast< char * >( stack_) + stack_size, stack_size, loop),
+                0);
+    }
+
+    ~fcontext_bench() {
+        // `loop` never returns; its stack is released without unwinding
+        std::free( stack_);
+    }
+
+    void run( std::size_t n) {
+        for ( std::size_t i = 0; i < n; ++i) {
+            t_ = ctx::detail::jump_fcontext( t_.fctx, 0);
+        }
+    }
+};
+
+void measure_fcontext( json_report & report, double overhead) {
+    measure< fcontext_bench >( report, "fcontext", overhead);
+}
@@ -0,0 +1,94 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+#include "../stats.hpp"
+#include "suite.hpp"
+
+boost::uint64_t repetitions = 1000;
+boost::uint64_t batch = 1000;
+boost::uint64_t warmup = 100;
+std::string filter;
+bool counters = false;
+std::string json_file;
+
+// cost of reading the clock twice; subtracted from each sample
+static double clock_overhead() {
+    std::vector< double > samples;
+    for ( int i = 0; i < 1000; ++i) {
+        time_point_type start( clock_type::now() );
+        samples.push_back( static_cast< double >( ( clock_type::now() - start).count() ) );
+    }
+    return summarize( samples).median;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("repetitions,r", boost::program_options::value< boost::uint64_t >( & repetitions), "samples per benchmark")
+            ("batch,b", boost::program_options::value< boost::uint64_t >( & batch), "round trips per sample")
+            ("warmup,w", boost::program_options::value< boost::uint64_t >( & warmup), "samples discarded before measuring")
+            ("counters,c", boost::program_options::bool_switch( & counters), "count cycles (rdtscp) and hardware events (perf_event_open) per switch")
+            ("filter,f", boost::program_options::value< std::string >( & filter), "run benchmarks whose name contains the string")
+            ("json,o", boost::program_options::value< std::string >( & json_file), "write results as JSON to file ('-' for stdout)");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if ( 0 == batch || 0 == repetitions) {
+            throw std::invalid_argument("batch and repetitions must not be zero");
+        }
+
+        const double overhead = clock_overhead();
+        json_report report;
+        measure_fcontext( report, overhead);
+        measure_callcc( report, overhead);
+        measure_execution_context( report, overhead);
+        measure_ucontext( report, overhead);
+        measure_winfiber( report, overhead);
+
+        if ( "-" == json_file) {
+            report.write( std::cout);
+        } else if ( ! json_file.empty() ) {
+            std::ofstream os( json_file.c_str() );
+            if ( ! os) {
+                throw std::runtime_error("can not open " + json_file);
+            }
+            report.write( os);
+        }
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,133 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SUITE_H
+#define SUITE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "../clock.hpp"
+#include "../cycle.hpp"
+#include "../perf_event.hpp"
+#include "../stats.hpp"
+
+// samples taken per benchmark
+extern boost::uint64_t repetitions;
+// round trips (two switches) per sample
+extern boost::uint64_t batch;
+// samples taken and discarded before measuring
+extern boost::uint64_t warmup;
+// only benchmarks whose name contains `filter` are run
+extern std::string filter;
+// count hardware events per switch
+extern bool counters;
+// '-' if the JSON report goes to stdout
+extern std::string json_file;
+
+// the table goes to stderr if stdout carries the JSON report
+inline
+std::ostream & table() {
+    return "-" == json_file ? std::cerr : std::cout;
+}
+
+const std::size_t stack_size = 64 * 1024;
+
+// events per switch, each counted in a separate pass of `repetitions`
+// batches (avoids multiplexing of the PMU); events that can not be counted
+// on this platform are omitted
+template< typename Bench >
+inline
+json_report::extra_type count_events( Bench & bench) {
+    json_report::extra_type extra;
+    const double switches = 2. * repetitions * batch;
+#if defined(BOOST_CONTEXT_CYCLE)
+    cycle_type start = cycles();
+    for ( boost::uint64_t i = 0; i < repetitions; ++i) {
+        bench.run( batch);
+    }
+    extra.emplace_back( "tsc_cycles", ( cycles_end() - start) / switches);
+#endif
+    static const perf_counter::event events[] = {
+        perf_counter::cycles,
+        perf_counter::instructions,
+        perf_counter::branch_misses,
+        perf_counter::l1d_misses,
+        perf_counter::l1i_misses,
+        perf_counter::dtlb_misses
+    };
+    for ( perf_counter::event e : events) {
+        perf_counter counter( e);
+        if ( ! counter.valid() ) {
+            continue;
+        }
+        counter.start();
+        for ( boost::uint64_t i = 0; i < repetitions; ++i) {
+            bench.run( batch);
+        }
+        counter.stop();
+        extra.emplace_back( perf_counter::name( e), counter.value() / switches);
+    }
+    return extra;
+}
+
+// nano seconds per switch; each sample is the mean over `batch` round trips
+template< typename Bench >
+inline
+void measure( json_report & report, char const* name, double overhead) {
+    if ( ! filter.empty() && std::string( name).find( filter) == std::string::npos) {
+        return;
+    }
+    Bench bench;
+    for ( boost::uint64_t i = 0; i < warmup; ++i) {
+        bench.run( batch);
+    }
+    std::vector< double > samples;
+    samples.reserve( repetitions);
+    for ( boost::uint64_t i = 0; i < repetitions; ++i) {
+        time_point_type start( clock_type::now() );
+        bench.run( batch);
+        const double elapsed = static_cast< double >( ( clock_type::now() - start).count() );
+        samples.push_back( ( std::max)( elapsed - overhead, 0.) / ( 2 * batch) );
+    }
+    json_report::extra_type extra;
+    if ( counters) {
+        extra = count_events( bench);
+    }
+    statistics const& s = report.add( name, "ns/switch", samples, extra);
+    table() << std::left << std::setw( 12) << name << std::right << std::fixed << std::setprecision( 2)
+              << " min " << std::setw( 8) << s.min
+              << " median " << std::setw( 8) << s.median
+              << " p99 " << std::setw( 8) << s.p99
+              << " p99.9 " << std::setw( 8) << s.p999
+              << " cv " << std::setw( 6) << s.cv
+              << "  (nano seconds per switch)" << std::endl;
+    if ( counters) {
+        table() << std::setw( 12) << "";
+        for ( auto const& x : extra) {
+            table() << " " << x.first << " " << x.second;
+        }
+        if ( ! perf_counter( perf_counter::instructions).valid() ) {
+            table() << " (hardware counters not available)";
+        }
+        table() << "  (per switch)" << std::endl;
+    }
+}
+
+// one function per mechanism, each in its own translation unit (the
+// headers of continuation and execution_context can not be combined)
+void measure_fcontext( json_report &, double);
+void measure_callcc( json_report &, double);
+void measure_execution_context( json_report &, double);
+void measure_ucontext( json_report &, double);
+void measure_winfiber( json_report &, double);
+
+#endif // SUITE_H
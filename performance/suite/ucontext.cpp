@@ -0,0 +1,66 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdlib>
+#include <new>
+
+#include <boost/config.hpp>
+
+#if ! defined(BOOST_WINDOWS)
+# include <ucontext.h>
+#endif
+
+#include "suite.hpp"
+
+#if ! defined(BOOST_WINDOWS)
+class ucontext_bench {
+private:
+    static ucontext_t   uc_;
+    static ucontext_t   ucm_;
+    void            *   stack_;
+
+    static void loop() {
+        while ( true) {
+            ::swapcontext( & uc_, & ucm_);
+        }
+    }
+
+public:
+    ucontext_bench() :
+        stack_( std::malloc( stack_size) ) {
+        if ( ! stack_) {
+            throw std::bad_alloc();
+        }
+        ::getcontext( & uc_);
+        uc_.uc_stack.ss_sp = stack_;
+        uc_.uc_stack.ss_size = stack_size;
+        uc_.uc_link = nullptr;
+        ::makecontext( & uc_, loop, 0);
+        ::swapcontext( & ucm_, & uc_);
+    }
+
+    ~ucontext_bench() {
+        std::free( stack_);
+    }
+
+    void run( std::size_t n) {
+        for ( std::size_t i = 0; i < n; ++i) {
+            ::swapcontext( & ucm_, & uc_);
+        }
+    }
+};
+
+ucontext_t ucontext_bench::uc_;
+ucontext_t ucontext_bench::ucm_;
+#endif
+
+void measure_ucontext( json_report & report, double overhead) {
+#if ! defined(BOOST_WINDOWS)
+    measure< ucontext_bench >( report, "ucontext", overhead);
+#else
+    ( void)report;
+    ( void)overhead;
+#endif
+}
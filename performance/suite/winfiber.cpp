@@ -0,0 +1,74 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <new>
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_WINDOWS)
+# include <windows.h>
+#endif
+
+#include "suite.hpp"
+
+#if defined(BOOST_WINDOWS)
+class winfiber_bench {
+private:
+    static LPVOID   fm_;
+    LPVOID          fc_;
+    bool            converted_;
+
+    static VOID __stdcall loop( LPVOID) {
+        while ( true) {
+            ::SwitchToFiber( fm_);
+        }
+    }
+
+public:
+    winfiber_bench() :
+        fc_( nullptr),
+        converted_( false) {
+        fm_ = ::ConvertThreadToFiber( nullptr);
+        if ( nullptr == fm_) {
+            // this thread is a fiber already
+            fm_ = ::GetCurrentFiber();
+        } else {
+            converted_ = true;
+        }
+        fc_ = ::CreateFiber( stack_size, loop, nullptr);
+        if ( nullptr == fc_) {
+            if ( converted_) {
+                ::ConvertFiberToThread();
+            }
+            throw std::bad_alloc();
+        }
+        ::SwitchToFiber( fc_);
+    }
+
+    ~winfiber_bench() {
+        ::DeleteFiber( fc_);
+        if ( converted_) {
+            ::ConvertFiberToThread();
+        }
+    }
+
+    void run( std::size_t n) {
+        for ( std::size_t i = 0; i < n; ++i) {
+            ::SwitchToFiber( fc_);
+        }
+    }
+};
+
+LPVOID winfiber_bench::fm_ = nullptr;
+#endif
+
+void measure_winfiber( json_report & report, double overhead) {
+#if defined(BOOST_WINDOWS)
+    measure< winfiber_bench >( report, "winfiber", overhead);
+#else
+    ( void)report;
+    ( void)overhead;
+#endif
+}
@@ -0,0 +1,181 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "../bind_processor.hpp"
+#include "../clock.hpp"
+#include "timer_wheel.hpp"
+
+boost::uint64_t timers = 1000000;
+boost::uint64_t range = 1 << 20;
+boost::uint64_t sleepers = 1000;
+boost::uint64_t rounds = 10;
+
+struct result {
+    duration_type   insert;
+    duration_type   cancel;
+    duration_type   expire;
+};
+
+static std::vector< std::uint64_t > make_deadlines() {
+    std::minstd_rand generator( 42);
+    std::uniform_int_distribution< std::uint64_t > distribution( 1, range);
+    std::vector< std::uint64_t > deadlines( timers);
+    for ( auto & d : deadlines) {
+        d = distribution( generator);
+    }
+    return deadlines;
+}
+
+static void count_expired( timer_node *) {
+}
+
+// time per operation; zero if no operation was done
+static duration_type per( duration_type d, std::size_t n) {
+    if ( 0 == n) {
+        return duration_type::zero();
+    }
+    return d / n;
+}
+
+// insert all timers, cancel every second one, expire the rest
+result measure_wheel( std::vector< std::uint64_t > const& deadlines) {
+    std::unique_ptr< timer_wheel > wheel( new timer_wheel() );
+    std::vector< timer_node > nodes( deadlines.size() );
+    for ( auto & n : nodes) {
+        n.fn = count_expired;
+    }
+    result r;
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < deadlines.size(); ++i) {
+        wheel->insert( & nodes[i], deadlines[i]);
+    }
+    r.insert = per( clock_type::now() - start, deadlines.size() );
+    start = clock_type::now();
+    for ( std::size_t i = 0; i < deadlines.size(); i += 2) {
+        wheel->cancel( & nodes[i]);
+    }
+    r.cancel = per( clock_type::now() - start, ( deadlines.size() + 1) / 2);
+    start = clock_type::now();
+    std::size_t expired = wheel->advance( range);
+    r.expire = per( clock_type::now() - start, expired);
+    return r;
+}
+
+result measure_priority_queue( std::vector< std::uint64_t > const& deadlines) {
+    typedef std::pair< std::uint64_t, std::size_t > entry_type;
+    std::priority_queue< entry_type, std::vector< entry_type >, std::greater< entry_type > > queue;
+    // std::priority_queue has no erase; cancellation is lazy: a flag is set
+    // and the entry is skipped when it is popped, so the queue work of a
+    // cancel is part of the expire cost
+    std::vector< bool > cancelled( deadlines.size(), false);
+    result r;
+    time_point_type start( clock_type::now() );
+    for ( std::size_t i = 0; i < deadlines.size(); ++i) {
+        queue.push( entry_type( deadlines[i], i) );
+    }
+    r.insert = per( clock_type::now() - start, deadlines.size() );
+    start = clock_type::now();
+    for ( std::size_t i = 0; i < deadlines.size(); i += 2) {
+        cancelled[i] = true;
+    }
+    r.cancel = per( clock_type::now() - start, ( deadlines.size() + 1) / 2);
+    start = clock_type::now();
+    std::size_t expired = 0;
+    while ( ! queue.empty() ) {
+        if ( ! cancelled[queue.top().second]) {
+            ++expired;
+        }
+        queue.pop();
+    }
+    r.expire = per( clock_type::now() - start, expired);
+    return r;
+}
+
+// continuations sleeping on the wheel; reports how late they were woken up
+duration_type measure_sleep() {
+    timer_service ts( std::chrono::milliseconds( 1) );
+    std::chrono::steady_clock::duration lateness{ 0 };
+    for ( boost::uint64_t i = 0; i < sleepers; ++i) {
+        ts.spawn( [&lateness,i]( timer_service & ts) {
+            std::minstd_rand generator( static_cast< unsigned >( i + 1) );
+            std::uniform_int_distribution< int > distribution( 1, 20);
+            for ( boost::uint64_t j = 0; j < rounds; ++j) {
+                auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds( distribution( generator) );
+                ts.sleep_until( deadline);
+                lateness += std::chrono::steady_clock::now() - deadline;
+            }
+        });
+    }
+    ts.run();
+    return boost::chrono::nanoseconds(
+        std::chrono::duration_cast< std::chrono::nanoseconds >( lateness).count() / ( sleepers * rounds) );
+}
+
+static void print( char const* name, result const& r, char const* cancel = "cancel") {
+    std::cout << name << ": insert " << r.insert.count() << " ns, " << cancel << " "
+              << r.cancel.count() << " ns, expire " << r.expire.count()
+              << " ns per timer" << std::endl;
+}
+
+int main( int argc, char * argv[]) {
+    try {
+        bind_to_processor( 0);
+
+        boost::program_options::options_description desc("allowed options");
+        desc.add_options()
+            ("help", "help message")
+            ("timers,t", boost::program_options::value< boost::uint64_t >( & timers), "concurrent timers")
+            ("range,r", boost::program_options::value< boost::uint64_t >( & range), "deadlines are spread over range ticks")
+            ("sleepers,s", boost::program_options::value< boost::uint64_t >( & sleepers), "sleeping continuations")
+            ("rounds,n", boost::program_options::value< boost::uint64_t >( & rounds), "sleeps per continuation");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+                boost::program_options::parse_command_line(
+                    argc,
+                    argv,
+                    desc),
+                vm);
+        boost::program_options::notify( vm);
+
+        if ( vm.count("help") ) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        if ( 2 > timers || 0 == range || 0 == sleepers || 0 == rounds) {
+            throw std::invalid_argument("timers must be at least 2; range, sleepers and rounds must not be zero");
+        }
+
+        std::vector< std::uint64_t > deadlines = make_deadlines();
+        print( "timer_wheel", measure_wheel( deadlines) );
+        // expire includes popping the cancelled timers
+        print( "std::priority_queue", measure_priority_queue( deadlines), "lazy cancel (flag only)");
+
+        boost::uint64_t res = measure_sleep().count();
+        std::cout << "sleep_until(): average wake-up lateness of " << res << " nano seconds" << std::endl;
+
+        return EXIT_SUCCESS;
+    } catch ( std::exception const& e) {
+        std::cerr << "exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "unhandled exception" << std::endl;
+    }
+    return EXIT_FAILURE;
+}
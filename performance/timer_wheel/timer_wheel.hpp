@@ -0,0 +1,363 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/context/continuation.hpp>
+
+// intrusive timer; lives in the memory of its owner (e.g. the stack of a
+// suspended continuation) so arming a timer never allocates
+struct timer_node {
+    timer_node      *   prev{ nullptr };
+    timer_node      *   next{ nullptr };
+    std::uint64_t       deadline{ 0 };
+    void            (*  fn)( timer_node *){ nullptr };
+
+    bool armed() const noexcept {
+        return nullptr != next;
+    }
+
+    // O(1)
+    void unlink() noexcept {
+        if ( armed() ) {
+            prev->next = next;
+            next->prev = prev;
+            prev = next = nullptr;
+        }
+    }
+};
+
+// hierarchical timing wheel with four levels of 256 slots each
+//
+// Timers are stored in the slot of the finest level that can represent their
+// distance to the current tick; insert and cancel are O(1). When level 0
+// wraps, the next slot of level 1 is cascaded into level 0 and so on.
+// Timers more than 2^32 ticks ahead wait in the last slot of the top level
+// and get re-inserted on each cascade. An occupancy bitmap of level 0 lets
+// advance() skip runs of empty slots.
+class timer_wheel {
+private:
+    enum {
+        slot_bits = 8,
+        slots = 1 << slot_bits,
+        slot_mask = slots - 1,
+        levels = 4
+    };
+
+    struct slot {
+        timer_node  head;
+
+        slot() noexcept {
+            head.prev = head.next = & head;
+        }
+
+        bool empty() const noexcept {
+            return head.next == & head;
+        }
+
+        void push_back( timer_node * n) noexcept {
+            n->next = & head;
+            n->prev = head.prev;
+            head.prev->next = n;
+            head.prev = n;
+        }
+
+        // moves all timers into `other`
+        void splice( slot & other) noexcept {
+            if ( empty() ) {
+                return;
+            }
+            head.next->prev = other.head.prev;
+            other.head.prev->next = head.next;
+            head.prev->next = & other.head;
+            other.head.prev = head.prev;
+            head.prev = head.next = & head;
+        }
+    };
+
+    slot            wheel_[levels][slots];
+    // bit set if slot of level 0 might be non-empty (cleared lazily)
+    std::uint64_t   occupied_[slots / 64];
+    // next tick to be processed
+    std::uint64_t   now_;
+    std::size_t     size_{ 0 };
+
+    void place_( timer_node * n) noexcept {
+        const std::uint64_t delta = n->deadline > now_ ? n->deadline - now_ : 0;
+        std::size_t level = 0;
+        while ( level < levels - 1 && delta >= ( std::uint64_t( 1) << ( ( level + 1) * slot_bits) ) ) {
+            ++level;
+        }
+        std::uint64_t tick = n->deadline > now_ ? n->deadline : now_;
+        if ( level == levels - 1 && delta >= ( std::uint64_t( 1) << ( levels * slot_bits) ) ) {
+            // too far ahead; park in the furthest slot of the top level
+            tick = now_ + ( ( std::uint64_t( slots) - 1) << ( level * slot_bits) );
+        }
+        const std::size_t idx = ( tick >> ( level * slot_bits) ) & slot_mask;
+        wheel_[level][idx].push_back( n);
+        if ( 0 == level) {
+            occupied_[idx / 64] |= std::uint64_t( 1) << ( idx % 64);
+        }
+    }
+
+    // first slot >= idx of level 0 that might hold timers, `slots` if none
+    std::size_t next_occupied_( std::size_t idx) const noexcept {
+        for ( std::size_t w = idx / 64; w < slots / 64; ++w) {
+            std::uint64_t bits = occupied_[w];
+            if ( w == idx / 64) {
+                bits &= ~std::uint64_t( 0) << ( idx % 64);
+            }
+            if ( 0 != bits) {
+                return w * 64 + __builtin_ctzll( bits);
+            }
+        }
+        return slots;
+    }
+
+    void cascade_( std::size_t level) noexcept {
+        slot tmp;
+        wheel_[level][( now_ >> ( level * slot_bits) ) & slot_mask].splice( tmp);
+        while ( ! tmp.empty() ) {
+            timer_node * n = tmp.head.next;
+            n->unlink();
+            place_( n);
+        }
+    }
+
+public:
+    explicit timer_wheel( std::uint64_t now = 0) noexcept :
+        occupied_(),
+        now_( now) {
+    }
+
+    timer_wheel( timer_wheel const&) = delete;
+    timer_wheel & operator=( timer_wheel const&) = delete;
+
+    std::uint64_t now() const noexcept {
+        return now_;
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    // O(1); a deadline in the past expires on the next advance()
+    void insert( timer_node * n, std::uint64_t deadline) noexcept {
+        BOOST_ASSERT( ! n->armed() );
+        n->deadline = deadline;
+        place_( n);
+        ++size_;
+    }
+
+    // O(1)
+    void cancel( timer_node * n) noexcept {
+        if ( n->armed() ) {
+            n->unlink();
+            --size_;
+        }
+    }
+
+    // processes all ticks up to and including `until`; expired timers of each
+    // tick are unlinked as one batch before their callbacks run, so callbacks
+    // may re-arm timers
+    std::size_t advance( std::uint64_t until) {
+        std::size_t expired = 0;
+        while ( now_ <= until) {
+            if ( 0 == size_) {
+                now_ = until + 1;
+                break;
+            }
+            std::size_t idx = now_ & slot_mask;
+            if ( 0 != idx) {
+                // skip empty slots up to the next cascade
+                const std::size_t next = next_occupied_( idx);
+                if ( next != idx) {
+                    now_ = ( std::min)( now_ + ( next - idx), until + 1);
+                    continue;
+                }
+            }
+            for ( std::size_t level = 1; level < levels; ++level) {
+                if ( 0 != ( ( now_ >> ( ( level - 1) * slot_bits) ) & slot_mask) ) {
+                    break;
+                }
+                cascade_( level);
+            }
+            slot batch;
+            wheel_[0][idx].splice( batch);
+            occupied_[idx / 64] &= ~( std::uint64_t( 1) << ( idx % 64) );
+            ++now_;
+            while ( ! batch.empty() ) {
+                timer_node * n = batch.head.next;
+                n->unlink();
+                --size_;
+                ++expired;
+                n->fn( n);
+            }
+        }
+        return expired;
+    }
+};
+
+// runs continuations that suspend on the timer wheel
+class timer_service {
+public:
+    typedef std::chrono::steady_clock   clock_type;
+
+    // cancellable timeout; invokes `fn` on expiry unless cancelled before
+    template< typename Fn >
+    class timeout : private timer_node {
+    private:
+        timer_service   &   ts_;
+        Fn                  fn_;
+
+        static void expire_( timer_node * n) {
+            static_cast< timeout * >( n)->fn_();
+        }
+
+    public:
+        timeout( timer_service & ts, clock_type::time_point tp, Fn fn) :
+            ts_( ts), fn_( std::move( fn) ) {
+            this->fn = & timeout::expire_;
+            ts_.wheel_.insert( this, ts_.to_tick_( tp) );
+        }
+
+        ~timeout() {
+            cancel();
+        }
+
+        timeout( timeout const&) = delete;
+        timeout & operator=( timeout const&) = delete;
+
+        void cancel() noexcept {
+            ts_.wheel_.cancel( this);
+        }
+
+        bool pending() const noexcept {
+            return armed();
+        }
+    };
+
+private:
+    struct task : public timer_node {
+        boost::context::continuation    caller{};
+        boost::context::continuation    self{};
+        timer_service               *   ts{ nullptr };
+    };
+
+    clock_type::time_point          epoch_;
+    clock_type::duration            resolution_;
+    timer_wheel                     wheel_{};
+    std::deque< task * >            ready_{};
+    task                        *   current_{ nullptr };
+    task                        *   suspended_{ nullptr };
+    std::size_t                     active_{ 0 };
+
+    std::uint64_t to_tick_( clock_type::time_point tp) const noexcept {
+        if ( tp <= epoch_) {
+            return 0;
+        }
+        // round up; a timer never fires early
+        return static_cast< std::uint64_t >( ( tp - epoch_ + resolution_ - clock_type::duration( 1) ) / resolution_);
+    }
+
+    static void wakeup_( timer_node * n) {
+        task * t = static_cast< task * >( n);
+        t->ts->ready_.push_back( t);
+    }
+
+    void resume_( task * t) {
+        current_ = t;
+        boost::context::continuation c = t->self.resume();
+        current_ = nullptr;
+        if ( c) {
+            t->self = std::move( c);
+        } else {
+            --active_;
+        }
+    }
+
+public:
+    explicit timer_service( clock_type::duration resolution = std::chrono::milliseconds( 1) ) :
+        epoch_( clock_type::now() ),
+        resolution_( resolution) {
+    }
+
+    timer_service( timer_service const&) = delete;
+    timer_service & operator=( timer_service const&) = delete;
+
+    template< typename Fn >
+    void spawn( Fn && fn) {
+        task * parent = current_;
+        ++active_;
+        boost::context::continuation c = boost::context::callcc(
+            [this,fn]( boost::context::continuation && caller) mutable {
+                task t;
+                t.caller = std::move( caller);
+                t.ts = this;
+                t.fn = & timer_service::wakeup_;
+                current_ = & t;
+                fn( * this);
+                current_ = nullptr;
+                return std::move( t.caller);
+            });
+        current_ = parent;
+        if ( c) {
+            suspended_->self = std::move( c);
+        } else {
+            --active_;
+        }
+    }
+
+    // suspends the calling continuation until `tp` has passed
+    void sleep_until( clock_type::time_point tp) {
+        BOOST_ASSERT_MSG( nullptr != current_, "sleep_until() must be called from a spawned continuation");
+        task * t = current_;
+        wheel_.insert( t, to_tick_( tp) );
+        suspended_ = t;
+        t->caller = t->caller.resume();
+        current_ = t;
+    }
+
+    template< typename Rep, typename Period >
+    void sleep_for( std::chrono::duration< Rep, Period > const& d) {
+        sleep_until( clock_type::now() + d);
+    }
+
+    std::size_t pending_timers() const noexcept {
+        return wheel_.size();
+    }
+
+    void run() {
+        while ( 0 < active_) {
+            while ( ! ready_.empty() ) {
+                task * t = ready_.front();
+                ready_.pop_front();
+                resume_( t);
+            }
+            if ( 0 == active_) {
+                break;
+            }
+            const clock_type::time_point now = clock_type::now();
+            // ticks whose end has passed are due
+            const std::uint64_t tick = static_cast< std::uint64_t >( ( now - epoch_) / resolution_);
+            if ( 0 == wheel_.advance( tick) && ready_.empty() ) {
+                std::this_thread::sleep_until( epoch_ + ( tick + 1) * resolution_);
+            }
+        }
+    }
+};
+
+#endif // TIMER_WHEEL_H
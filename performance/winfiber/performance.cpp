@@ -57,7 +57,7 @@ cycle_type measure_cycles()
     for ( std::size_t i = 0; i < jobs; ++i) {
         ::SwitchToFiber( fc);
     }
-    cycle_type total = cycles() - start;
+    cycle_type total = cycles_end() - start;
     total -= overhead_cycle(); // overhead of measurement
     total /= jobs;  // loops
     total /= 2;  // 2x jump_fcontext
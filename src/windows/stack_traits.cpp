@@ -122,6 +122,21 @@ stack_traits::maximum_size() BOOST_NOEXCEPT_OR_NOTHROW {
     return  1 * 1024 * 1024 * 1024; // 1GB
 }
 
+namespace detail {
+
+// dynamically initialized while the library is loaded; zero-initialized
+// before, which makes cached_stack_traits fall back to stack_traits
+BOOST_CONTEXT_DECL
+stack_traits_cache stack_traits_values = {
+    stack_traits::page_size(),
+    stack_traits::default_size(),
+    stack_traits::minimum_size(),
+    stack_traits::is_unbounded() ? 0 : stack_traits::maximum_size(),
+    stack_traits::is_unbounded()
+};
+
+}
+
 }}
 
 #ifdef BOOST_HAS_ABI_HEADERS
@@ -0,0 +1,191 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <boost/context/arena.hpp>
+#include <boost/context/continuation.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+
+namespace ctx = boost::context;
+
+static bool in_stack( ctx::stack_context const& sctx, void * p) {
+    char * top = static_cast< char * >( sctx.sp);
+    return top - sctx.size <= p && p < top;
+}
+
+void test_allocate() {
+    ctx::fixedsize_stack salloc;
+    ctx::stack_context sctx = salloc.allocate();
+    void * p1 = nullptr, * p2 = nullptr;
+    ctx::continuation c = ctx::callcc(
+        std::allocator_arg, ctx::preallocated( sctx.sp, sctx.size, sctx), salloc,
+        [&p1,&p2]( ctx::continuation && c) {
+            p1 = ctx::arena_allocate( 24);
+            p2 = ctx::arena_allocate( 100, 64);
+            return std::move( c);
+        });
+    BOOST_CHECK( ! c);
+    // both served from the arena on the context's stack
+    BOOST_CHECK( in_stack( sctx, p1) );
+    BOOST_CHECK( in_stack( sctx, p2) );
+    BOOST_CHECK( p1 != p2);
+    BOOST_CHECK_EQUAL( 0u, reinterpret_cast< std::uintptr_t >( p1) % alignof( std::max_align_t) );
+    BOOST_CHECK_EQUAL( 0u, reinterpret_cast< std::uintptr_t >( p2) % 64);
+}
+
+void test_lifo() {
+    ctx::continuation c = ctx::callcc(
+        []( ctx::continuation && c) {
+            void * p1 = ctx::arena_allocate( 32);
+            ctx::arena_deallocate( p1, 32);
+            // most recent allocation was given back
+            void * p2 = ctx::arena_allocate( 32);
+            BOOST_CHECK_EQUAL( p1, p2);
+            void * p3 = ctx::arena_allocate( 32);
+            ctx::arena_deallocate( p2, 32);
+            // not the most recent allocation; kept until the context terminates
+            void * p4 = ctx::arena_allocate( 32);
+            BOOST_CHECK( p4 != p2);
+            BOOST_CHECK( p4 != p3);
+            return std::move( c);
+        });
+    BOOST_CHECK( ! c);
+}
+
+void test_overflow() {
+    ctx::continuation c = ctx::callcc(
+        []( ctx::continuation && c) {
+            // exceeds the arena; served from the free-store and released
+            // when the context terminates
+            std::vector< void * > v;
+            for ( std::size_t i = 0; i < 4 * BOOST_CONTEXT_ARENA_SIZE / 64; ++i) {
+                void * p = ctx::arena_allocate( 64);
+                BOOST_CHECK( nullptr != p);
+                v.push_back( p);
+            }
+            for ( std::size_t i = 1; i < v.size(); ++i) {
+                BOOST_CHECK( v[i - 1] != v[i]);
+            }
+            // owned by the arena, not passed to the free-store
+            ctx::arena_deallocate( v.back(), 64);
+            c = c.resume();
+            return std::move( c);
+        });
+    BOOST_CHECK( c);
+    c = c.resume();
+    BOOST_CHECK( ! c);
+}
+
+void test_allocator() {
+    int sum = 0;
+    ctx::continuation c = ctx::callcc(
+        [&sum]( ctx::continuation && c) {
+            std::vector< int, ctx::arena_allocator< int > > v;
+            for ( int i = 0; i < 100; ++i) {
+                v.push_back( i);
+                c = c.resume();
+            }
+            for ( int i : v) {
+                sum += i;
+            }
+            return std::move( c);
+        });
+    // allocations of other contexts do not interfere
+    std::vector< int, ctx::arena_allocator< int > > v( 100, 1);
+    while ( c) {
+        c = c.resume();
+    }
+    BOOST_CHECK_EQUAL( 4950, sum);
+    BOOST_CHECK_EQUAL( 100u, v.size() );
+}
+
+void test_allocator_equality() {
+    ctx::arena_allocator< int > m1, m2;
+    ctx::arena_allocator< int > a, b;
+    ctx::continuation c1 = ctx::callcc(
+        [&a]( ctx::continuation && c) {
+            a = ctx::arena_allocator< int >();
+            return c.resume();
+        });
+    ctx::continuation c2 = ctx::callcc(
+        [&b]( ctx::continuation && c) {
+            b = ctx::arena_allocator< int >();
+            return c.resume();
+        });
+    // main context: free-store
+    BOOST_CHECK( m1 == m2);
+    BOOST_CHECK( m1 != a);
+    BOOST_CHECK( a != b);
+    ctx::arena_allocator< char > ac( a);
+    BOOST_CHECK( ac == a);
+    // the vector moves its elements instead of stealing memory of the arena
+    std::vector< int, ctx::arena_allocator< int > > v( 10, 1, a);
+    std::vector< int, ctx::arena_allocator< int > > w( m1);
+    w = std::move( v);
+    BOOST_CHECK_EQUAL( 10u, w.size() );
+    BOOST_CHECK( w.get_allocator() == m1);
+    w.clear();
+    w.shrink_to_fit();
+}
+
+void test_overaligned() {
+    // main context: served from the free-store
+    void * p = ctx::arena_allocate( 100, 256);
+    BOOST_CHECK_EQUAL( 0u, reinterpret_cast< std::uintptr_t >( p) % 256);
+    ctx::arena_deallocate( p, 100, 256);
+}
+
+void test_small_stack() {
+    alignas( 64) static char buffer[4096];
+    ctx::stack_context sctx;
+    sctx.size = sizeof( buffer);
+    sctx.sp = buffer + sizeof( buffer);
+    // the arena does not fit; the stack is not touched
+    BOOST_CHECK_THROW(
+        ctx::callcc(
+            std::allocator_arg, ctx::preallocated( sctx.sp, sctx.size, sctx), ctx::fixedsize_stack(),
+            []( ctx::continuation && c) {
+                return std::move( c);
+            }),
+        std::invalid_argument);
+}
+
+void test_unwind() {
+    bool done = false;
+    {
+        ctx::continuation c = ctx::callcc(
+            [&done]( ctx::continuation && c) {
+                std::vector< int, ctx::arena_allocator< int > > v( 2 * BOOST_CONTEXT_ARENA_SIZE, 1);
+                done = true;
+                return c.resume();
+            });
+        BOOST_CHECK( done);
+    }
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
+{
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Context: arena test suite");
+
+    test->add( BOOST_TEST_CASE( & test_allocate) );
+    test->add( BOOST_TEST_CASE( & test_lifo) );
+    test->add( BOOST_TEST_CASE( & test_overflow) );
+    test->add( BOOST_TEST_CASE( & test_allocator) );
+    test->add( BOOST_TEST_CASE( & test_allocator_equality) );
+    test->add( BOOST_TEST_CASE( & test_overaligned) );
+    test->add( BOOST_TEST_CASE( & test_small_stack) );
+    test->add( BOOST_TEST_CASE( & test_unwind) );
+
+    return test;
+}
@@ -10,6 +10,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -613,6 +614,122 @@ void test_snprintf() {
 	});
 }
 
+void test_make_continuation() {
+    value1 = 0;
+    ctx::continuation c = ctx::make_continuation(
+        []( ctx::continuation && c) {
+            value1 = 3;
+            c = c.resume();
+            value1 = 7;
+            return std::move( c);
+        });
+    // not started yet
+    BOOST_CHECK( c);
+    BOOST_CHECK_EQUAL( 0, value1);
+    c = c.resume();
+    BOOST_CHECK( c);
+    BOOST_CHECK_EQUAL( 3, value1);
+    c = c.resume();
+    BOOST_CHECK( ! c);
+    BOOST_CHECK_EQUAL( 7, value1);
+}
+
+void test_make_continuation_arg() {
+    ctx::fixedsize_stack alloc;
+    ctx::continuation c = ctx::make_continuation(
+        std::allocator_arg, alloc,
+        []( ctx::continuation && c) {
+            // arguments of the first resume()
+            int i = c.get_data< int >();
+            return c.resume( i + 1);
+        });
+    c = c.resume( 41);
+    BOOST_CHECK_EQUAL( 42, c.get_data< int >() );
+    c = c.resume();
+    BOOST_CHECK( ! c);
+}
+
+void test_make_continuation_unwind() {
+    value1 = 0;
+    {
+        ctx::continuation c = ctx::make_continuation(
+            []( ctx::continuation && c) {
+                value1 = 3;
+                return std::move( c);
+            });
+    }
+    // destroyed before it was started; the context-function never ran
+    BOOST_CHECK_EQUAL( 0, value1);
+}
+
+void test_make_continuation_batch() {
+    std::vector< ctx::continuation > v;
+    int started = 0;
+    for ( int i = 0; i < 100; ++i) {
+        v.push_back( ctx::make_continuation(
+            [&started]( ctx::continuation && c) {
+                ++started;
+                return std::move( c);
+            }) );
+    }
+    BOOST_CHECK_EQUAL( 0, started);
+    for ( ctx::continuation & c : v) {
+        c = c.resume();
+        BOOST_CHECK( ! c);
+    }
+    BOOST_CHECK_EQUAL( 100, started);
+}
+
+// stack provided by the test; nothing to release
+struct untouched_stack {
+    void deallocate( ctx::stack_context &) noexcept {
+    }
+};
+
+const std::size_t untouched_size = 64 * 1024;
+alignas( 4096) char untouched[2][untouched_size];
+
+ctx::continuation fn_untouched( ctx::continuation && c) {
+    value1 = 3;
+    return std::move( c);
+}
+
+// lowest byte of the stack that no longer holds the pattern
+std::size_t lowest_touched( char const* stack) {
+    std::size_t i = 0;
+    while ( i < untouched_size && '\xA5' == stack[i]) {
+        ++i;
+    }
+    return i;
+}
+
+void test_make_continuation_untouched() {
+    using Record = ctx::detail::record< ctx::continuation, untouched_stack, ctx::continuation(&)( ctx::continuation &&) >;
+    value1 = 0;
+    std::memset( untouched, 0xA5, sizeof( untouched) );
+    ctx::stack_context sctx0;
+    sctx0.sp = untouched[0] + untouched_size;
+    sctx0.size = untouched_size;
+    ctx::stack_context sctx1;
+    sctx1.sp = untouched[1] + untouched_size;
+    sctx1.size = untouched_size;
+    ctx::continuation c = ctx::make_continuation(
+            std::allocator_arg, ctx::preallocated( sctx0.sp, sctx0.size, sctx0), untouched_stack{}, fn_untouched);
+    // same layout without any jump: control structure and initial frame only
+    ctx::detail::transfer_t t = ctx::detail::context_prepare< Record >(
+            ctx::preallocated( sctx1.sp, sctx1.size, sctx1), untouched_stack{}, fn_untouched,
+            & ctx::detail::context_suspended_entry< Record >, true);
+    const std::size_t created = lowest_touched( untouched[0]);
+    BOOST_CHECK_EQUAL( lowest_touched( untouched[1]), created);
+    static_cast< Record * >( t.data)->deallocate();
+    BOOST_CHECK_EQUAL( 0, value1);
+    // the first resume() is the first jump into the context
+    c = c.resume();
+    BOOST_CHECK( ! c);
+    BOOST_CHECK_EQUAL( 3, value1);
+    BOOST_CHECK( lowest_touched( untouched[0]) < created);
+}
+
 #ifdef BOOST_WINDOWS
 void test_bug12215() {
         ctx::continuation c = ctx::callcc(
@@ -644,6 +761,11 @@ boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
     test->add( BOOST_TEST_CASE( & test_variant) );
     test->add( BOOST_TEST_CASE( & test_sscanf) );
     test->add( BOOST_TEST_CASE( & test_snprintf) );
+    test->add( BOOST_TEST_CASE( & test_make_continuation) );
+    test->add( BOOST_TEST_CASE( & test_make_continuation_arg) );
+    test->add( BOOST_TEST_CASE( & test_make_continuation_unwind) );
+    test->add( BOOST_TEST_CASE( & test_make_continuation_batch) );
+    test->add( BOOST_TEST_CASE( & test_make_continuation_untouched) );
 #ifdef BOOST_WINDOWS
     test->add( BOOST_TEST_CASE( & test_bug12215) );
 #endif
@@ -0,0 +1,170 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+
+#if ! defined(BOOST_WINDOWS)
+extern "C" {
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+}
+#endif
+
+#if ! defined(BOOST_USE_STACK_CANARY)
+# error "BOOST_USE_STACK_CANARY must be defined"
+#endif
+
+namespace ctx = boost::context;
+
+const std::size_t stack_size = 16 * 1024;
+
+void test_install() {
+    ctx::fixedsize_stack salloc( stack_size);
+    ctx::stack_context sctx = salloc.allocate();
+    // canary sits at the limit of the stack
+    BOOST_CHECK_EQUAL( static_cast< char * >( sctx.sp) - sctx.size, sctx.canary);
+    salloc.deallocate( sctx);
+}
+
+void test_switch() {
+    ctx::pooled_fixedsize_stack salloc( stack_size);
+    int value = 0;
+    ctx::continuation c = ctx::callcc( std::allocator_arg, salloc,
+        [&value]( ctx::continuation && c) {
+            for ( int i = 0; i < 10; ++i) {
+                // some stack usage, well above the limit
+                char buffer[1024];
+                buffer[0] = static_cast< char >( i);
+                value += buffer[0];
+                c = c.resume();
+            }
+            return std::move( c);
+        });
+    while ( c) {
+        c = c.resume();
+    }
+    BOOST_CHECK_EQUAL( 45, value);
+}
+
+void test_main_context() {
+    // the main context has no canary; nothing is checked
+    ctx::continuation c = ctx::callcc(
+        []( ctx::continuation && c) {
+            return c.resume();
+        });
+    c = c.resume();
+    BOOST_CHECK( ! c);
+}
+
+#if ! defined(BOOST_WINDOWS)
+// records the stack it hands out
+class spy_stack {
+private:
+    ctx::fixedsize_stack        salloc_{ stack_size };
+    ctx::stack_context      *   sctx_;
+
+public:
+    spy_stack( ctx::stack_context * sctx) noexcept :
+        sctx_( sctx) {
+    }
+
+    ctx::stack_context allocate() {
+        return * sctx_ = salloc_.allocate();
+    }
+
+    void deallocate( ctx::stack_context & sctx) noexcept {
+        salloc_.deallocate( sctx);
+    }
+};
+
+// runs `fn` in a child process; true if it was terminated by abort()
+template< typename Fn >
+bool aborts( Fn fn) {
+    const pid_t pid = ::fork();
+    BOOST_REQUIRE( -1 != pid);
+    if ( 0 == pid) {
+        // no core dump
+        ::signal( SIGABRT, SIG_DFL);
+        ::close( 2);
+        fn();
+        std::_Exit( 0);
+    }
+    int status = 0;
+    ::waitpid( pid, & status, 0);
+    return WIFSIGNALED( status) && SIGABRT == WTERMSIG( status);
+}
+
+// the topmost word of the canary is overwritten; detected when the
+// context is suspended
+void test_detect_at_switch() {
+    BOOST_CHECK( aborts( [](){
+        ctx::stack_context sctx;
+        ctx::continuation c = ctx::callcc( std::allocator_arg, spy_stack( & sctx),
+            [&sctx]( ctx::continuation && c) {
+                static_cast< std::uint64_t * >( sctx.canary)[BOOST_CONTEXT_CANARY_WORDS - 1] = 0;
+                return c.resume();
+            });
+    }) );
+}
+
+// the lowest word of the canary is overwritten; not checked at context
+// switch, but detected when the stack is deallocated
+void test_detect_at_deallocation() {
+    BOOST_CHECK( aborts( [](){
+        ctx::stack_context sctx;
+        ctx::continuation c = ctx::callcc( std::allocator_arg, spy_stack( & sctx),
+            [&sctx]( ctx::continuation && c) {
+                static_cast< std::uint64_t * >( sctx.canary)[0] = 0;
+                c = c.resume();
+                return std::move( c);
+            });
+        c = c.resume();
+    }) );
+}
+
+// intact canary
+void test_no_false_positive() {
+    BOOST_CHECK( ! aborts( [](){
+        ctx::stack_context sctx;
+        ctx::continuation c = ctx::callcc( std::allocator_arg, spy_stack( & sctx),
+            []( ctx::continuation && c) {
+                c = c.resume();
+                return std::move( c);
+            });
+        c = c.resume();
+    }) );
+}
+#endif
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
+{
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Context: stack canary test suite");
+
+    test->add( BOOST_TEST_CASE( & test_install) );
+    test->add( BOOST_TEST_CASE( & test_switch) );
+    test->add( BOOST_TEST_CASE( & test_main_context) );
+#if ! defined(BOOST_WINDOWS)
+    test->add( BOOST_TEST_CASE( & test_detect_at_switch) );
+    test->add( BOOST_TEST_CASE( & test_detect_at_deallocation) );
+    test->add( BOOST_TEST_CASE( & test_no_false_positive) );
+#endif
+
+    return test;
+}
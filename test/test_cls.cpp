@@ -0,0 +1,120 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <thread>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/continuation_local.hpp>
+
+namespace ctx = boost::context;
+
+ctx::continuation_local_ptr< int > cls_value;
+
+int value1 = 0;
+
+struct Y {
+    ~Y() {
+        // executed while the context is unwound
+        value1 = nullptr != cls_value.get() ? * cls_value : -1;
+    }
+};
+
+void test_main_context() {
+    BOOST_CHECK( nullptr == cls_value.get() );
+    int i = 1;
+    cls_value.reset( & i);
+    BOOST_CHECK_EQUAL( & i, cls_value.get() );
+    std::thread t( [](){
+        // each thread has its own main-context slots
+        BOOST_CHECK( nullptr == cls_value.get() );
+    });
+    t.join();
+    cls_value.reset();
+}
+
+void test_separate_values() {
+    int m = 0;
+    cls_value.reset( & m);
+    int i1 = 1, i2 = 2;
+    ctx::continuation c1 = ctx::callcc(
+        [&i1]( ctx::continuation && c) {
+            BOOST_CHECK( nullptr == cls_value.get() );
+            cls_value.reset( & i1);
+            for (;;) {
+                c = c.resume( * cls_value);
+            }
+            return std::move( c);
+        });
+    BOOST_CHECK_EQUAL( 1, c1.get_data< int >() );
+    BOOST_CHECK_EQUAL( & m, cls_value.get() );
+    ctx::continuation c2 = ctx::callcc(
+        [&i2,&c1]( ctx::continuation && c) {
+            cls_value.reset( & i2);
+            // switching to c1 and back keeps the value of `this` context
+            c1 = c1.resume();
+            BOOST_CHECK_EQUAL( 1, c1.get_data< int >() );
+            c = c.resume( * cls_value);
+            return std::move( c);
+        });
+    BOOST_CHECK_EQUAL( 2, c2.get_data< int >() );
+    BOOST_CHECK_EQUAL( & m, cls_value.get() );
+    c1 = c1.resume();
+    BOOST_CHECK_EQUAL( 1, c1.get_data< int >() );
+    BOOST_CHECK_EQUAL( & m, cls_value.get() );
+    cls_value.reset();
+}
+
+void test_unwind() {
+    value1 = 0;
+    {
+        int i = 3;
+        ctx::continuation c = ctx::callcc(
+            [&i]( ctx::continuation && c) {
+                cls_value.reset( & i);
+                Y y;
+                return c.resume();
+            });
+        BOOST_CHECK( nullptr == cls_value.get() );
+    }
+    BOOST_CHECK_EQUAL( 3, value1);
+    BOOST_CHECK( nullptr == cls_value.get() );
+}
+
+void test_migration() {
+    int i = 7;
+    ctx::continuation c = ctx::callcc(
+        [&i]( ctx::continuation && c) {
+            cls_value.reset( & i);
+            c = c.resume();
+            // resumed by another thread
+            c = c.resume( * cls_value);
+            return std::move( c);
+        });
+    std::thread t( [&c](){
+        c = c.resume();
+        BOOST_CHECK_EQUAL( 7, c.get_data< int >() );
+        BOOST_CHECK( nullptr == cls_value.get() );
+        c = c.resume();
+        BOOST_CHECK( ! c);
+    });
+    t.join();
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
+{
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Context: continuation-local storage test suite");
+
+    test->add( BOOST_TEST_CASE( & test_main_context) );
+    test->add( BOOST_TEST_CASE( & test_separate_values) );
+    test->add( BOOST_TEST_CASE( & test_unwind) );
+    test->add( BOOST_TEST_CASE( & test_migration) );
+
+    return test;
+}
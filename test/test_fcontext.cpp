@@ -22,6 +22,7 @@
 
 #include <boost/context/detail/config.hpp>
 #include <boost/context/detail/fcontext.hpp>
+#include <boost/context/detail/jump_preserve_none.hpp>
 
 template< std::size_t Max, std::size_t Default, std::size_t Min >
 class simple_stack_allocator
@@ -190,6 +191,61 @@ void f14( ctx::transfer_t t) {
     ctx::jump_fcontext( t.fctx, 0);
 }
 
+#if defined(BOOST_CONTEXT_HAS_JUMP_RET)
+void f15( ctx::transfer_t t_) {
+    std::pair< int, int > data = * ( std::pair< int, int > * ) t_.data;
+    int res = data.first + data.second;
+    ctx::transfer_t t = ctx::jump_fcontext_ret( t_.fctx, & res);
+    data = * ( std::pair< int, int > *) t.data;
+    res = data.first + data.second;
+    ctx::jump_fcontext_ret( t.fctx, & res);
+}
+
+void f16( ctx::transfer_t t_) {
+    ctx::transfer_t t = ctx::jump_fcontext_ret( t_.fctx, t_.data);
+    value1 = * ( int *) t.data;
+    ctx::jump_fcontext_ret( t.fctx, t.data);
+}
+
+// alternates jump_fcontext() and jump_fcontext_ret(); the caller switches
+// with the other routine
+void f17( ctx::transfer_t t_) {
+    ++value1;
+    ctx::transfer_t t = ctx::jump_fcontext( t_.fctx, t_.data);
+    ++value1;
+    t = ctx::jump_fcontext_ret( t.fctx, t.data);
+    ++value1;
+    ctx::jump_fcontext( t.fctx, t.data);
+}
+#endif
+
+typedef ctx::transfer_t ( * jump_type)( ctx::fcontext_t const, void *);
+
+template< jump_type Jump >
+void f18( ctx::transfer_t t_) {
+    std::pair< int, int > data = * ( std::pair< int, int > * ) t_.data;
+    int res = data.first + data.second;
+    ctx::transfer_t t = Jump( t_.fctx, & res);
+    data = * ( std::pair< int, int > *) t.data;
+    res = data.first + data.second;
+    Jump( t.fctx, & res);
+}
+
+// alternates jump_fcontext() and `Jump`; values kept in registers across
+// the switches must survive
+template< jump_type Jump >
+void f19( ctx::transfer_t t_) {
+    double d = * ( double *) t_.data;
+    int n = value1 + 1;
+    value1 = n;
+    ctx::transfer_t t = ctx::jump_fcontext( t_.fctx, t_.data);
+    value1 = ++n;
+    t = Jump( t.fctx, t.data);
+    value1 = ++n;
+    value3 = d + * ( double *) t.data;
+    ctx::jump_fcontext( t.fctx, t.data);
+}
+
 void test_setup() {
     stack_allocator alloc;
     void * sp = alloc.allocate( stack_allocator::default_stacksize() );
@@ -332,6 +388,106 @@ void test_snprintf() {
 	alloc.deallocate( sp, stack_allocator::default_stacksize() );
 }
 
+#if defined(BOOST_CONTEXT_HAS_JUMP_RET)
+void test_transfer_ret() {
+    stack_allocator alloc;
+    std::pair< int, int > data = std::make_pair( 3, 7);
+    void * sp = alloc.allocate( stack_allocator::default_stacksize() );
+    ctx::fcontext_t ctx = ctx::make_fcontext( sp, stack_allocator::default_stacksize(), f15);
+    BOOST_CHECK( ctx);
+    ctx::transfer_t t = ctx::jump_fcontext_ret( ctx, & data);
+    int result = * ( int *) t.data;
+    BOOST_CHECK_EQUAL( 10, result);
+    data = std::make_pair( 7, 7);
+    t = ctx::jump_fcontext_ret( t.fctx, & data);
+    result = * ( int *) t.data;
+    BOOST_CHECK_EQUAL( 14, result);
+	alloc.deallocate( sp, stack_allocator::default_stacksize() );
+}
+
+void test_ontop_ret() {
+    value1 = 0;
+    value4 = 0;
+    stack_allocator alloc;
+    void * sp = alloc.allocate( stack_allocator::default_stacksize() );
+    ctx::fcontext_t ctx = ctx::make_fcontext( sp, stack_allocator::default_stacksize(), f16);
+    BOOST_CHECK( ctx);
+    ctx::transfer_t t = ctx::jump_fcontext_ret( ctx, 0);
+    BOOST_CHECK_EQUAL( 0, value1);
+    BOOST_CHECK( 0 == value4);
+    // resumes the context suspended by jump_fcontext_ret()
+    int i = -3;
+    t = ctx::ontop_fcontext( t.fctx, & i, f11);
+    BOOST_CHECK_EQUAL( -3, value1);
+    BOOST_CHECK_EQUAL( & i, value4);
+    BOOST_CHECK_EQUAL( -3, * ( int *) t.data);
+    BOOST_CHECK_EQUAL( & i, ( int *) t.data);
+	alloc.deallocate( sp, stack_allocator::default_stacksize() );
+}
+
+void test_jump_mixed() {
+    value1 = 0;
+    stack_allocator alloc;
+    int i = 7;
+    void * sp = alloc.allocate( stack_allocator::default_stacksize() );
+    ctx::fcontext_t ctx = ctx::make_fcontext( sp, stack_allocator::default_stacksize(), f17);
+    BOOST_CHECK( ctx);
+    // this context is suspended by jump_fcontext_ret() and resumed by
+    // jump_fcontext(), and vice versa
+    ctx::transfer_t t = ctx::jump_fcontext_ret( ctx, & i);
+    BOOST_CHECK_EQUAL( 1, value1);
+    BOOST_CHECK_EQUAL( & i, ( int *) t.data);
+    t = ctx::jump_fcontext( t.fctx, & i);
+    BOOST_CHECK_EQUAL( 2, value1);
+    BOOST_CHECK_EQUAL( & i, ( int *) t.data);
+    t = ctx::jump_fcontext_ret( t.fctx, & i);
+    BOOST_CHECK_EQUAL( 3, value1);
+    BOOST_CHECK_EQUAL( 7, * ( int *) t.data);
+	alloc.deallocate( sp, stack_allocator::default_stacksize() );
+}
+#endif
+
+template< jump_type Jump >
+void test_transfer_preserve_none() {
+    stack_allocator alloc;
+    std::pair< int, int > data = std::make_pair( 3, 7);
+    void * sp = alloc.allocate( stack_allocator::default_stacksize() );
+    ctx::fcontext_t ctx = ctx::make_fcontext( sp, stack_allocator::default_stacksize(), f18< Jump >);
+    BOOST_CHECK( ctx);
+    ctx::transfer_t t = Jump( ctx, & data);
+    int result = * ( int *) t.data;
+    BOOST_CHECK_EQUAL( 10, result);
+    data = std::make_pair( 7, 7);
+    t = Jump( t.fctx, & data);
+    result = * ( int *) t.data;
+    BOOST_CHECK_EQUAL( 14, result);
+	alloc.deallocate( sp, stack_allocator::default_stacksize() );
+}
+
+template< jump_type Jump >
+void test_jump_mixed_preserve_none() {
+    value1 = 0;
+    value3 = 0.;
+    stack_allocator alloc;
+    double d = 1.25;
+    void * sp = alloc.allocate( stack_allocator::default_stacksize() );
+    ctx::fcontext_t ctx = ctx::make_fcontext( sp, stack_allocator::default_stacksize(), f19< Jump >);
+    BOOST_CHECK( ctx);
+    // this context is suspended by `Jump` and resumed by jump_fcontext(),
+    // and vice versa
+    ctx::transfer_t t = Jump( ctx, & d);
+    BOOST_CHECK_EQUAL( 1, value1);
+    BOOST_CHECK_EQUAL( & d, ( double *) t.data);
+    t = ctx::jump_fcontext( t.fctx, & d);
+    BOOST_CHECK_EQUAL( 2, value1);
+    BOOST_CHECK_EQUAL( & d, ( double *) t.data);
+    d = 2.5;
+    t = Jump( t.fctx, & d);
+    BOOST_CHECK_EQUAL( 3, value1);
+    BOOST_CHECK_EQUAL( 3.75, value3);
+	alloc.deallocate( sp, stack_allocator::default_stacksize() );
+}
+
 boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
     boost::unit_test::test_suite * test =
         BOOST_TEST_SUITE("Boost.Context: context test suite");
@@ -347,6 +503,15 @@ boost::unit_test::test_suite * init_unit_test_suite( int, char* []) {
     test->add( BOOST_TEST_CASE( & test_ontop) );
     test->add( BOOST_TEST_CASE( & test_sscanf) );
     test->add( BOOST_TEST_CASE( & test_snprintf) );
+#if defined(BOOST_CONTEXT_HAS_JUMP_RET)
+    test->add( BOOST_TEST_CASE( & test_transfer_ret) );
+    test->add( BOOST_TEST_CASE( & test_ontop_ret) );
+    test->add( BOOST_TEST_CASE( & test_jump_mixed) );
+#endif
+#if defined(BOOST_CONTEXT_HAS_JUMP_MINIMAL)
+    test->add( BOOST_TEST_CASE( & test_transfer_preserve_none< ctx::jump_fcontext_minimal >) );
+    test->add( BOOST_TEST_CASE( & test_jump_mixed_preserve_none< ctx::jump_fcontext_minimal >) );
+#endif
 
     return test;
 }
@@ -0,0 +1,200 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/handoff.hpp>
+#include <boost/context/tls_access.hpp>
+
+namespace ctx = boost::context;
+
+// number of workers a continuation is passed around
+const int workers = 4;
+// each continuation visits every worker `rounds` times
+const int rounds = 100000;
+
+thread_local int worker_id = -1;
+
+int value1 = 0;
+
+struct Y {
+    Y() {
+        value1 = 3;
+    }
+
+    ~Y() {
+        value1 = 7;
+    }
+};
+
+static int current_worker() {
+    return ctx::tls_access( []() noexcept -> int & { return worker_id; });
+}
+
+void test_handoff() {
+    ctx::handoff h;
+    BOOST_CHECK( h.empty() );
+    BOOST_CHECK( ! h.try_take() );
+    value1 = 0;
+    ctx::continuation c = ctx::callcc(
+        []( ctx::continuation && c) {
+            c = c.resume();
+            value1 = 1;
+            return std::move( c);
+        });
+    BOOST_CHECK( c);
+    BOOST_CHECK( h.try_put( std::move( c) ) );
+    BOOST_CHECK( ! c);
+    BOOST_CHECK( ! h.empty() );
+    ctx::continuation other = ctx::callcc(
+        []( ctx::continuation && c) {
+            return c.resume();
+        });
+    // slot is occupied; `other` stays valid
+    BOOST_CHECK( ! h.try_put( std::move( other) ) );
+    BOOST_CHECK( other);
+    c = h.take();
+    BOOST_CHECK( h.empty() );
+    c = c.resume();
+    BOOST_CHECK( ! c);
+    BOOST_CHECK_EQUAL( 1, value1);
+}
+
+void test_handoff_unwind() {
+    value1 = 0;
+    {
+        ctx::handoff h;
+        h.put( ctx::callcc(
+            []( ctx::continuation && c) {
+                Y y;
+                return c.resume();
+            }) );
+        BOOST_CHECK_EQUAL( 3, value1);
+    }
+    // never taken; unwound by the destructor of handoff
+    BOOST_CHECK_EQUAL( 7, value1);
+}
+
+void test_handoff_not_started() {
+    value1 = 0;
+    {
+        ctx::handoff h;
+        h.put( ctx::make_continuation(
+            []( ctx::continuation && c) {
+                value1 = 3;
+                return std::move( c);
+            }) );
+        // passed on twice; destroyed by `~handoff()` before it was resumed
+        ctx::continuation c = h.take();
+        BOOST_CHECK( c);
+        h.put( std::move( c) );
+    }
+    BOOST_CHECK_EQUAL( 0, value1);
+}
+
+void test_tls_access() {
+    worker_id = 0;
+    ctx::continuation c = ctx::callcc(
+        []( ctx::continuation && c) {
+            c = c.resume( current_worker() );
+            c = c.resume( current_worker() );
+            return std::move( c);
+        });
+    BOOST_CHECK_EQUAL( 0, c.get_data< int >() );
+    ctx::handoff h;
+    h.put( std::move( c) );
+    std::thread t( [&h](){
+        worker_id = 1;
+        ctx::continuation c = h.take();
+        c = c.resume();
+        // resumed on this thread; must not observe worker_id of main thread
+        BOOST_CHECK_EQUAL( 1, c.get_data< int >() );
+        c = c.resume();
+        BOOST_CHECK( ! c);
+    });
+    t.join();
+}
+
+void test_migration_stress() {
+    std::vector< std::unique_ptr< ctx::handoff > > slots;
+    for ( int i = 0; i < workers; ++i) {
+        slots.emplace_back( new ctx::handoff() );
+    }
+    std::atomic< std::size_t > errors{ 0 };
+    std::atomic< std::size_t > hops{ 0 };
+    // one continuation less than workers, so a worker never waits for itself
+    const int tokens = workers - 1;
+    for ( int i = 0; i < tokens; ++i) {
+        slots[i]->put( ctx::callcc(
+            [&errors,&hops,i]( ctx::continuation && c) {
+                // state on the stack must survive every migration
+                std::uint64_t stack_data[16];
+                for ( std::uint64_t & d : stack_data) {
+                    d = static_cast< std::uint64_t >( i);
+                }
+                c = c.resume();
+                while ( c.data_available() ) {
+                    const int worker = c.get_data< int >();
+                    if ( worker != current_worker() ) {
+                        ++errors;
+                    }
+                    for ( std::uint64_t & d : stack_data) {
+                        if ( d != static_cast< std::uint64_t >( i) ) {
+                            ++errors;
+                        }
+                    }
+                    ++hops;
+                    c = c.resume();
+                }
+                return std::move( c);
+            }) );
+    }
+    std::vector< std::thread > threads;
+    for ( int i = 0; i < workers; ++i) {
+        threads.emplace_back( [&slots,i,tokens](){
+            worker_id = i;
+            for ( int n = 0; n < tokens * rounds; ++n) {
+                ctx::continuation c = slots[i]->take();
+                c = c.resume( current_worker() );
+                slots[( i + 1) % workers]->put( std::move( c) );
+            }
+        });
+    }
+    for ( std::thread & t : threads) {
+        t.join();
+    }
+    // every continuation is back in the slot it started from
+    for ( int i = 0; i < tokens; ++i) {
+        ctx::continuation c = slots[i]->take();
+        c = c.resume();
+        BOOST_CHECK( ! c);
+    }
+    BOOST_CHECK_EQUAL( 0u, errors.load() );
+    BOOST_CHECK_EQUAL( static_cast< std::size_t >( tokens * rounds * workers), hops.load() );
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
+{
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Context: migration test suite");
+
+    test->add( BOOST_TEST_CASE( & test_handoff) );
+    test->add( BOOST_TEST_CASE( & test_handoff_unwind) );
+    test->add( BOOST_TEST_CASE( & test_handoff_not_started) );
+    test->add( BOOST_TEST_CASE( & test_tls_access) );
+    test->add( BOOST_TEST_CASE( & test_migration_stress) );
+
+    return test;
+}
@@ -0,0 +1,267 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/prefaulted_stack.hpp>
+#include <boost/context/slab_protected_stack.hpp>
+#include <boost/context/stack_traits.hpp>
+
+#if defined(__linux__)
+extern "C" {
+#include <sys/mman.h>
+}
+#endif
+
+#if ! defined(BOOST_WINDOWS)
+extern "C" {
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+}
+#endif
+
+namespace ctx = boost::context;
+
+const std::size_t stack_size = 64 * 1024;
+const std::size_t prefault_size = 16 * 1024;
+
+#if defined(__linux__)
+// true if all pages of [sp - size, sp) are resident
+static bool resident( void * sp, std::size_t size) {
+    const std::size_t page_size = ctx::stack_traits::page_size();
+    std::uintptr_t top = reinterpret_cast< std::uintptr_t >( sp);
+    std::uintptr_t bottom = ( top - size) & ~( page_size - 1);
+    std::vector< unsigned char > vec( ( top - bottom + page_size - 1) / page_size);
+    if ( 0 != ::mincore( reinterpret_cast< void * >( bottom), top - bottom, vec.data() ) ) {
+        return false;
+    }
+    for ( unsigned char c : vec) {
+        if ( 0 == ( c & 1) ) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+void test_prefaulted_stack() {
+    ctx::prefaulted_protected_fixedsize_stack salloc(
+            prefault_size, false, ctx::protected_fixedsize_stack( stack_size) );
+    ctx::stack_context sctx = salloc.allocate();
+    BOOST_CHECK( nullptr != sctx.sp);
+    BOOST_CHECK_EQUAL( stack_size, sctx.size);
+#if defined(__linux__)
+    BOOST_CHECK( resident( sctx.sp, prefault_size) );
+#endif
+    salloc.deallocate( sctx);
+    // nothing reserved; nothing cached
+    BOOST_CHECK_EQUAL( 0u, salloc.cached() );
+}
+
+void test_prefaulted_fixedsize_stack() {
+    // the stack top returned by malloc() is not page aligned; the lowest
+    // page of the prefaulted range is only partially covered
+    ctx::prefaulted_fixedsize_stack salloc(
+            prefault_size, false, ctx::fixedsize_stack( stack_size) );
+    ctx::stack_context sctx = salloc.allocate();
+    BOOST_CHECK( nullptr != sctx.sp);
+#if defined(__linux__)
+    BOOST_CHECK( resident( sctx.sp, prefault_size) );
+#endif
+    salloc.deallocate( sctx);
+}
+
+void test_prefaulted_stack_lock_protected() {
+    ctx::prefaulted_protected_fixedsize_stack salloc(
+            prefault_size, true, ctx::protected_fixedsize_stack( stack_size) );
+    ctx::stack_context sctx;
+    try {
+        sctx = salloc.allocate();
+    } catch ( std::bad_alloc const&) {
+        // RLIMIT_MEMLOCK too low
+        return;
+    }
+#if defined(__linux__)
+    BOOST_CHECK( resident( sctx.sp, prefault_size) );
+#endif
+    salloc.deallocate( sctx);
+}
+
+void test_prefaulted_stack_lock() {
+    // stacks of fixedsize_stack are not made up of whole pages
+    BOOST_CHECK_THROW(
+        ctx::prefaulted_fixedsize_stack( prefault_size, true, ctx::fixedsize_stack( stack_size) ),
+        std::invalid_argument);
+}
+
+void test_prefaulted_stack_reserve() {
+    ctx::prefaulted_protected_fixedsize_stack salloc(
+            prefault_size, false, ctx::protected_fixedsize_stack( stack_size) );
+    salloc.reserve( 4);
+    BOOST_CHECK_EQUAL( 4u, salloc.cached() );
+    std::vector< ctx::stack_context > stacks;
+    for ( int i = 0; i < 5; ++i) {
+        stacks.push_back( salloc.allocate() );
+    }
+    // the fifth stack was created on demand
+    BOOST_CHECK_EQUAL( 0u, salloc.cached() );
+    for ( ctx::stack_context & sctx : stacks) {
+        salloc.deallocate( sctx);
+    }
+    // only the reserved number of stacks is kept
+    BOOST_CHECK_EQUAL( 4u, salloc.cached() );
+}
+
+void test_prefaulted_stack_callcc() {
+    ctx::prefaulted_protected_fixedsize_stack salloc(
+            prefault_size, false, ctx::protected_fixedsize_stack( stack_size) );
+    salloc.reserve( 2);
+    int value = 0;
+    for ( int i = 0; i < 4; ++i) {
+        ctx::continuation c = ctx::callcc( std::allocator_arg, salloc,
+            [&value]( ctx::continuation && c) {
+                ++value;
+                c = c.resume();
+                ++value;
+                return std::move( c);
+            });
+        c = c.resume();
+        BOOST_CHECK( ! c);
+    }
+    BOOST_CHECK_EQUAL( 8, value);
+    // stacks went back to the shared cache
+    BOOST_CHECK_EQUAL( 2u, salloc.cached() );
+}
+
+#if ! defined(BOOST_WINDOWS)
+void test_slab_protected_stack() {
+    ctx::slab_protected_stack salloc( stack_size, 2);
+    ctx::stack_context sctx1 = salloc.allocate();
+    ctx::stack_context sctx2 = salloc.allocate();
+    BOOST_CHECK_EQUAL( stack_size, sctx1.size);
+    // carved from the same slab; the guard page of the upper stack is the
+    // boundary of the lower one
+    BOOST_CHECK_EQUAL( static_cast< char * >( sctx1.sp) + stack_size, sctx2.sp);
+    ctx::stack_context sctx3 = salloc.allocate();
+    std::size_t vmas = salloc.guard_regions() ? 2 : 2 * 2 * 2;
+    BOOST_CHECK_EQUAL( vmas, salloc.vma_count() );
+    void * sp = sctx2.sp;
+    salloc.deallocate( sctx2);
+    // deallocated stacks are reused
+    sctx2 = salloc.allocate();
+    BOOST_CHECK_EQUAL( sp, sctx2.sp);
+    BOOST_CHECK_EQUAL( vmas, salloc.vma_count() );
+    salloc.deallocate( sctx1);
+    salloc.deallocate( sctx2);
+    salloc.deallocate( sctx3);
+}
+
+// writes to `p` in a child process; true if the child was killed by SIGSEGV
+static bool write_faults( volatile char * p) {
+    const pid_t pid = ::fork();
+    if ( 0 == pid) {
+        // the test framework catches SIGSEGV
+        ::signal( SIGSEGV, SIG_DFL);
+        * p = 1;
+        ::_exit( 0);
+    }
+    if ( -1 == pid) {
+        return false;
+    }
+    int status = 0;
+    while ( -1 == ::waitpid( pid, & status, 0) && EINTR == errno) {
+    }
+    return WIFSIGNALED( status) && SIGSEGV == WTERMSIG( status);
+}
+
+void test_slab_protected_stack_guard() {
+    ctx::slab_protected_stack salloc( stack_size, 2);
+    ctx::stack_context sctx1 = salloc.allocate();
+    ctx::stack_context sctx2 = salloc.allocate();
+    const std::size_t page_size = ctx::stack_traits::page_size();
+    // the lowest page of each stack is the guard page, either a guard
+    // region or protected by mprotect()
+    volatile char * bottom1 = static_cast< char * >( sctx1.sp) - sctx1.size;
+    volatile char * bottom2 = static_cast< char * >( sctx2.sp) - sctx2.size;
+    BOOST_CHECK( write_faults( bottom1) );
+    BOOST_CHECK( write_faults( bottom1 + page_size - 1) );
+    BOOST_CHECK( write_faults( bottom2) );
+    // the page above the guard page is usable
+    bottom1[page_size] = 1;
+    bottom2[page_size] = 1;
+    BOOST_CHECK( ! write_faults( bottom1 + page_size) );
+    salloc.deallocate( sctx1);
+    salloc.deallocate( sctx2);
+}
+
+void test_slab_protected_stack_callcc() {
+    ctx::slab_protected_stack salloc( stack_size, 16);
+    std::vector< ctx::continuation > cs;
+    int value = 0;
+    for ( int i = 0; i < 64; ++i) {
+        cs.push_back( ctx::callcc( std::allocator_arg, salloc,
+            [&value]( ctx::continuation && c) {
+                char buffer[1024];
+                buffer[0] = 1;
+                c = c.resume();
+                value += buffer[0];
+                return std::move( c);
+            }) );
+    }
+    for ( ctx::continuation & c : cs) {
+        c = c.resume();
+        BOOST_CHECK( ! c);
+    }
+    BOOST_CHECK_EQUAL( 64, value);
+}
+
+void test_vma_count() {
+# if defined(__linux__)
+    const std::size_t before = ctx::process_vma_count();
+    BOOST_CHECK( 0 < before);
+    BOOST_CHECK( 0 < ctx::max_vma_count() );
+    ctx::slab_protected_stack salloc( stack_size, 64);
+    ctx::stack_context sctx = salloc.allocate();
+    // separate VMAs might get merged with adjacent mappings
+    BOOST_CHECK( ctx::process_vma_count() <= before + salloc.vma_count() );
+    salloc.deallocate( sctx);
+# endif
+}
+#endif
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
+{
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Context: stack allocator test suite");
+
+    test->add( BOOST_TEST_CASE( & test_prefaulted_stack) );
+    test->add( BOOST_TEST_CASE( & test_prefaulted_fixedsize_stack) );
+    test->add( BOOST_TEST_CASE( & test_prefaulted_stack_lock) );
+    test->add( BOOST_TEST_CASE( & test_prefaulted_stack_lock_protected) );
+    test->add( BOOST_TEST_CASE( & test_prefaulted_stack_reserve) );
+    test->add( BOOST_TEST_CASE( & test_prefaulted_stack_callcc) );
+#if ! defined(BOOST_WINDOWS)
+    test->add( BOOST_TEST_CASE( & test_slab_protected_stack) );
+    test->add( BOOST_TEST_CASE( & test_slab_protected_stack_guard) );
+    test->add( BOOST_TEST_CASE( & test_slab_protected_stack_callcc) );
+    test->add( BOOST_TEST_CASE( & test_vma_count) );
+#endif
+
+    return test;
+}
@@ -0,0 +1,167 @@
+//          Copyright Oliver Kowalke 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <boost/context/continuation.hpp>
+#include <boost/context/static_continuation.hpp>
+
+namespace ctx = boost::context;
+
+typedef ctx::static_continuation< 16 * 1024 >   generator_type;
+
+int value1 = 0;
+
+struct Y {
+    Y() {
+        value1 = 3;
+    }
+
+    ~Y() {
+        value1 = 7;
+    }
+};
+
+static bool in_object( generator_type const& g, void * p) {
+    char const* begin = reinterpret_cast< char const* >( & g);
+    return begin <= p && p < begin + sizeof( g);
+}
+
+void test_generator() {
+    generator_type g(
+        []( ctx::continuation && c) {
+            for ( int i = 0; i < 3; ++i) {
+                c = c.resume( i);
+            }
+            return std::move( c);
+        });
+    BOOST_CHECK( g);
+    for ( int i = 0; i < 3; ++i) {
+        g.resume();
+        BOOST_CHECK( g);
+        BOOST_CHECK_EQUAL( i, g.get_data< int >() );
+    }
+    g.resume();
+    BOOST_CHECK( ! g);
+}
+
+void test_embedded_stack() {
+    std::unique_ptr< generator_type > g( new generator_type() );
+    BOOST_CHECK( ! * g);
+    void * local = nullptr;
+    g->reset(
+        [&local]( ctx::continuation && c) {
+            int i = 0;
+            local = & i;
+            return c.resume();
+        });
+    g->resume();
+    // the context-function runs on the stack inside the object
+    BOOST_CHECK( in_object( * g, local) );
+}
+
+void test_array() {
+    const std::size_t n = 64;
+    std::unique_ptr< generator_type[] > gs( new generator_type[n]);
+    int sum = 0;
+    for ( std::size_t i = 0; i < n; ++i) {
+        gs[i].reset(
+            [&sum,i]( ctx::continuation && c) {
+                sum += static_cast< int >( i);
+                return std::move( c);
+            });
+    }
+    BOOST_CHECK_EQUAL( 0, sum);
+    for ( std::size_t i = 0; i < n; ++i) {
+        gs[i].resume();
+        BOOST_CHECK( ! gs[i]);
+    }
+    BOOST_CHECK_EQUAL( static_cast< int >( n * ( n - 1) / 2), sum);
+}
+
+void test_unwind() {
+    value1 = 0;
+    {
+        generator_type g(
+            []( ctx::continuation && c) {
+                Y y;
+                return c.resume();
+            });
+        g.resume();
+        BOOST_CHECK_EQUAL( 3, value1);
+    }
+    BOOST_CHECK_EQUAL( 7, value1);
+    value1 = 0;
+    generator_type g(
+        []( ctx::continuation && c) {
+            Y y;
+            return c.resume();
+        });
+    g.resume();
+    BOOST_CHECK_EQUAL( 3, value1);
+    // reuses the stack for another context
+    g.reset(
+        []( ctx::continuation && c) {
+            return std::move( c);
+        });
+    BOOST_CHECK_EQUAL( 7, value1);
+    g.resume();
+    BOOST_CHECK( ! g);
+}
+
+void test_min_stack() {
+    typedef ctx::static_continuation< ctx::static_continuation_min_stack > min_type;
+    value1 = 0;
+    {
+        // destroyed while suspended
+        min_type g(
+            []( ctx::continuation && c) {
+                Y y;
+                return c.resume();
+            });
+        g.resume();
+        BOOST_CHECK( g);
+        BOOST_CHECK_EQUAL( 3, value1);
+    }
+    BOOST_CHECK_EQUAL( 7, value1);
+    value1 = 0;
+    min_type g(
+        []( ctx::continuation && c) {
+            Y y;
+            for ( int i = 0;; ++i) {
+                c = c.resume( i);
+            }
+            return std::move( c);
+        });
+    BOOST_CHECK_EQUAL( 0, g.resume().get_data< int >() );
+    BOOST_CHECK_EQUAL( 1, g.resume().get_data< int >() );
+    // reset while suspended
+    g.reset(
+        []( ctx::continuation && c) {
+            return c.resume();
+        });
+    BOOST_CHECK_EQUAL( 7, value1);
+    g.resume();
+    BOOST_CHECK( g);
+}
+
+boost::unit_test::test_suite * init_unit_test_suite( int, char* [])
+{
+    boost::unit_test::test_suite * test =
+        BOOST_TEST_SUITE("Boost.Context: static_continuation test suite");
+
+    test->add( BOOST_TEST_CASE( & test_generator) );
+    test->add( BOOST_TEST_CASE( & test_embedded_stack) );
+    test->add( BOOST_TEST_CASE( & test_array) );
+    test->add( BOOST_TEST_CASE( & test_unwind) );
+    test->add( BOOST_TEST_CASE( & test_min_stack) );
+
+    return test;
+}